@@ -21,6 +21,7 @@
 #include "extensions/browser/extension_util.h"
 #include "extensions/common/extension.h"
 #include "extensions/common/extension_set.h"
+#include "extensions/common/one_shot_event.h"
 
 using extensions::Extension;
 using extensions::ExtensionInfo;
@@ -70,10 +71,17 @@ EphemeralAppService::EphemeralAppService(Profile* profile)
 
   extension_registry_observer_.Add(
       extensions::ExtensionRegistry::Get(profile_));
-  registrar_.Add(this, chrome::NOTIFICATION_EXTENSIONS_READY,
-                 content::Source<Profile>(profile_));
   registrar_.Add(this, chrome::NOTIFICATION_PROFILE_DESTROYED,
                  content::Source<Profile>(profile_));
+
+  // The service is created by a deferred startup task, usually after the
+  // extension system has already signalled that it is ready.
+  if (ExtensionSystem::Get(profile_)->ready().is_signaled()) {
+    Init();
+  } else {
+    registrar_.Add(this, chrome::NOTIFICATION_EXTENSIONS_READY,
+                   content::Source<Profile>(profile_));
+  }
 }
 
 EphemeralAppService::~EphemeralAppService() {
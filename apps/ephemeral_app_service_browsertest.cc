@@ -12,6 +12,7 @@
 #include "extensions/browser/extension_prefs.h"
 #include "extensions/browser/extension_system.h"
 #include "extensions/common/manifest.h"
+#include "extensions/common/one_shot_event.h"
 
 using extensions::Extension;
 using extensions::ExtensionPrefs;
@@ -50,6 +51,11 @@ class EphemeralAppServiceBrowserTest : public EphemeralAppTestBase {
     ephemeral_service->InitEphemeralAppCount();
   }
 
+  bool IsGarbageCollectionScheduled(EphemeralAppService* ephemeral_service) {
+    return ephemeral_service->garbage_collect_apps_timer_.IsRunning() &&
+           ephemeral_service->garbage_collect_data_timer_.IsRunning();
+  }
+
   std::vector<std::string> app_ids_;
 };
 
@@ -129,3 +135,14 @@ IN_PROC_BROWSER_TEST_F(EphemeralAppServiceBrowserTest,
   PromoteEphemeralApp(app);
   EXPECT_EQ(0, ephemeral_service->ephemeral_app_count());
 }
+
+// Verify that a service created after the extension system is ready, as the
+// deferred startup task creates it, still initializes itself.
+IN_PROC_BROWSER_TEST_F(EphemeralAppServiceBrowserTest,
+                       CreatedAfterExtensionsReady) {
+  ASSERT_TRUE(ExtensionSystem::Get(browser()->profile())->ready().is_signaled());
+
+  EphemeralAppService ephemeral_service(browser()->profile());
+  EXPECT_EQ(0, ephemeral_service.ephemeral_app_count());
+  EXPECT_TRUE(IsGarbageCollectionScheduled(&ephemeral_service));
+}
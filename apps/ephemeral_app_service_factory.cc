@@ -45,7 +45,9 @@ content::BrowserContext* EphemeralAppServiceFactory::GetBrowserContextToUse(
 }
 
 bool EphemeralAppServiceFactory::ServiceIsCreatedWithBrowserContext() const {
-  return true;
+  // Created by a deferred startup task once the first browser window has been
+  // shown, see ProfileManager::DoFinalInitForServices().
+  return false;
 }
 
 bool EphemeralAppServiceFactory::ServiceIsNULLWhileTesting() const {
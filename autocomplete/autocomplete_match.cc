@@ -190,6 +190,25 @@ bool AutocompleteMatch::DestinationsEqual(const AutocompleteMatch& elem1,
   return elem1.stripped_destination_url == elem2.stripped_destination_url;
 }
 
+// static
+bool AutocompleteMatch::DisplayEqual(const AutocompleteMatch& elem1,
+                                     const AutocompleteMatch& elem2) {
+  if (elem1.type != elem2.type ||
+      elem1.starred != elem2.starred ||
+      elem1.keyword != elem2.keyword ||
+      elem1.contents != elem2.contents ||
+      !(elem1.contents_class == elem2.contents_class) ||
+      elem1.description != elem2.description ||
+      !(elem1.description_class == elem2.description_class) ||
+      elem1.answer_contents != elem2.answer_contents ||
+      elem1.answer_type != elem2.answer_type ||
+      elem1.additional_info != elem2.additional_info)
+    return false;
+  if (!elem1.associated_keyword || !elem2.associated_keyword)
+    return !elem1.associated_keyword && !elem2.associated_keyword;
+  return DisplayEqual(*elem1.associated_keyword, *elem2.associated_keyword);
+}
+
 // static
 void AutocompleteMatch::ClassifyMatchInString(
     const base::string16& find_text,
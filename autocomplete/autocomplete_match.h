@@ -66,6 +66,10 @@ struct AutocompleteMatch {
           style(style) {
     }
 
+    bool operator==(const ACMatchClassification& other) const {
+      return offset == other.offset && style == other.style;
+    }
+
     // Offset within the string that this classification starts
     size_t offset;
 
@@ -115,6 +119,13 @@ struct AutocompleteMatch {
   static bool DestinationsEqual(const AutocompleteMatch& elem1,
                                 const AutocompleteMatch& elem2);
 
+  // Returns true if |elem1| and |elem2| look the same in the omnibox popup,
+  // including their associated keyword matches, so a popup row showing one
+  // can show the other without being re-rendered.  Fields that are not
+  // displayed, such as |relevance|, are ignored.
+  static bool DisplayEqual(const AutocompleteMatch& elem1,
+                           const AutocompleteMatch& elem2);
+
   // Helper functions for classes creating matches:
   // Fills in the classifications for |text|, using |style| as the base style
   // and marking the first instance of |find_text| as a match.  (This match
@@ -4,7 +4,11 @@
 
 #include "chrome/browser/autocomplete/autocomplete_match.h"
 
+#include <vector>
+
 #include "base/basictypes.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 TEST(AutocompleteMatchTest, MoreRelevant) {
@@ -127,3 +131,76 @@ TEST(AutocompleteMatchTest, SupportsDeletion) {
       NULL, 0, true, AutocompleteMatchType::URL_WHAT_YOU_TYPED));
   EXPECT_TRUE(m.SupportsDeletion());
 }
+
+TEST(AutocompleteMatchTest, DisplayEqual) {
+  AutocompleteMatch m1(NULL, 1000, false,
+                       AutocompleteMatchType::HISTORY_URL);
+  m1.contents = base::ASCIIToUTF16("example.com");
+  m1.contents_class.push_back(
+      ACMatchClassification(0, ACMatchClassification::URL));
+  m1.description = base::ASCIIToUTF16("Example");
+  m1.description_class.push_back(
+      ACMatchClassification(0, ACMatchClassification::NONE));
+  m1.destination_url = GURL("http://example.com/");
+
+  // Fields that aren't displayed don't matter.
+  AutocompleteMatch m2(m1);
+  m2.relevance = 1200;
+  m2.inline_autocompletion = base::ASCIIToUTF16("ple.com");
+  EXPECT_TRUE(AutocompleteMatch::DisplayEqual(m1, m2));
+
+  // Displayed fields do.
+  m2.contents_class[0].style = ACMatchClassification::URL |
+                               ACMatchClassification::MATCH;
+  EXPECT_FALSE(AutocompleteMatch::DisplayEqual(m1, m2));
+  m2 = m1;
+  m2.description = base::ASCIIToUTF16("Other");
+  EXPECT_FALSE(AutocompleteMatch::DisplayEqual(m1, m2));
+  m2 = m1;
+  m2.starred = true;
+  EXPECT_FALSE(AutocompleteMatch::DisplayEqual(m1, m2));
+
+  // So do associated keywords.
+  m2 = m1;
+  m2.associated_keyword.reset(new AutocompleteMatch(m1));
+  EXPECT_FALSE(AutocompleteMatch::DisplayEqual(m1, m2));
+  m1.associated_keyword.reset(new AutocompleteMatch(m2));
+  m1.associated_keyword->associated_keyword.reset();
+  EXPECT_TRUE(AutocompleteMatch::DisplayEqual(m1, m2));
+  m1.associated_keyword->contents = base::ASCIIToUTF16("keyword");
+  EXPECT_FALSE(AutocompleteMatch::DisplayEqual(m1, m2));
+}
+
+// Simulates the result churn of fast typing, where providers keep rescoring
+// mostly the same matches, and checks that only rows whose display changed
+// would be re-rendered.
+TEST(AutocompleteMatchTest, DisplayEqualResultChurn) {
+  const size_t kRows = 6;
+  const int kKeystrokes = 20;
+  const int kUpdatesPerKeystroke = 4;
+
+  std::vector<AutocompleteMatch> rows(kRows);
+  size_t rendered_rows = 0;
+  for (int keystroke = 0; keystroke < kKeystrokes; ++keystroke) {
+    // Each keystroke bolds one more character of every match.
+    for (int update = 0; update < kUpdatesPerKeystroke; ++update) {
+      for (size_t row = 0; row < kRows; ++row) {
+        AutocompleteMatch match(NULL, 1000 - update - static_cast<int>(row),
+                                false, AutocompleteMatchType::HISTORY_URL);
+        match.contents = base::ASCIIToUTF16(
+            "www.example" + base::IntToString(row) + ".com/path/to/page");
+        match.contents_class.push_back(
+            ACMatchClassification(0, ACMatchClassification::URL |
+                                     ACMatchClassification::MATCH));
+        match.contents_class.push_back(
+            ACMatchClassification(keystroke + 1, ACMatchClassification::URL));
+        if (!AutocompleteMatch::DisplayEqual(rows[row], match))
+          ++rendered_rows;
+        rows[row] = match;
+      }
+    }
+  }
+
+  // Only the first update after each keystroke changes what rows look like.
+  EXPECT_EQ(kRows * kKeystrokes, rendered_rows);
+}
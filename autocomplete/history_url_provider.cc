@@ -221,6 +221,21 @@ double CalculateRelevanceUsingScoreBuckets(
       score_bucket->second : undecayed_relevance;
 }
 
+// Like URLPrefix::BestURLPrefix() with an empty suffix, but compares |spec|
+// against |utf8_prefixes|, the UTF-8 forms of |prefixes|, so that history rows
+// don't need to be converted to UTF-16 first.
+const URLPrefix* BestURLPrefixForSpec(
+    const std::string& spec,
+    const URLPrefixes& prefixes,
+    const std::vector<std::string>& utf8_prefixes) {
+  DCHECK_EQ(prefixes.size(), utf8_prefixes.size());
+  for (size_t i = 0; i < prefixes.size(); ++i) {
+    if (StartsWithASCII(spec, utf8_prefixes[i], false))
+      return &prefixes[i];
+  }
+  return NULL;
+}
+
 }  // namespace
 
 // -----------------------------------------------------------------
@@ -528,32 +543,35 @@ void HistoryURLProvider::DoAutocomplete(history::HistoryBackend* backend,
 
   if (search_url_database_) {
     const URLPrefixes& prefixes = URLPrefix::GetURLPrefixes();
+    std::vector<std::string> utf8_prefixes;
+    std::vector<std::string> prefixed_inputs;
+    const std::string input_text(base::UTF16ToUTF8(params->input.text()));
     for (URLPrefixes::const_iterator i(prefixes.begin()); i != prefixes.end();
          ++i) {
-      if (params->cancel_flag.IsSet())
-        return;  // Canceled in the middle of a query, give up.
-      // We only need kMaxMatches results in the end, but before we
-      // get there we need to promote lower-quality matches that are
-      // prefixes of higher-quality matches, and remove lower-quality
-      // redirects.  So we ask for more results than we need, of every
-      // prefix type, in hopes this will give us far more than enough
-      // to work with.  CullRedirects() will then reduce the list to
-      // the best kMaxMatches results.
-      db->AutocompleteForPrefix(
-          base::UTF16ToUTF8(i->prefix + params->input.text()),
-          kMaxMatches * 2,
-          (backend == NULL),
-          &url_matches);
-      for (history::URLRows::const_iterator j(url_matches.begin());
-           j != url_matches.end(); ++j) {
-        const URLPrefix* best_prefix =
-            URLPrefix::BestURLPrefix(base::UTF8ToUTF16(j->url().spec()),
-                                     base::string16());
-        DCHECK(best_prefix != NULL);
-        history_matches.push_back(history::HistoryMatch(*j, i->prefix.length(),
-            i->num_components == 0,
-            i->num_components >= best_prefix->num_components));
-      }
+      utf8_prefixes.push_back(base::UTF16ToUTF8(i->prefix));
+      prefixed_inputs.push_back(utf8_prefixes.back() + input_text);
+    }
+    // We only need kMaxMatches results in the end, but before we get there we
+    // need to promote lower-quality matches that are prefixes of
+    // higher-quality matches, and remove lower-quality redirects.  So we ask
+    // for more results than we need, of every prefix type, in hopes this will
+    // give us far more than enough to work with.  CullRedirects() will then
+    // reduce the list to the best kMaxMatches results.  All prefix types are
+    // looked up together so the database is only queried once.
+    history::URLDatabase::PrefixedURLRows url_matches;
+    db->AutocompleteForPrefixes(prefixed_inputs, kMaxMatches * 2,
+                                (backend == NULL), &url_matches);
+    if (params->cancel_flag.IsSet())
+      return;  // Canceled while querying, give up.
+    for (history::URLDatabase::PrefixedURLRows::const_iterator j(
+             url_matches.begin()); j != url_matches.end(); ++j) {
+      const URLPrefix& prefix = prefixes[j->second];
+      const URLPrefix* best_prefix =
+          BestURLPrefixForSpec(j->first.url().spec(), prefixes, utf8_prefixes);
+      DCHECK(best_prefix != NULL);
+      history_matches.push_back(history::HistoryMatch(j->first,
+          prefix.prefix.length(), prefix.num_components == 0,
+          prefix.num_components >= best_prefix->num_components));
     }
   }
 
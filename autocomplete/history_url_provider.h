@@ -42,14 +42,14 @@ class URLDatabase;
 //         -> SuggestExactInput
 //         [params_ allocated]
 //         -> DoAutocomplete (for inline autocomplete)
-//           -> URLDatabase::AutocompleteForPrefix (on in-memory DB)
+//           -> URLDatabase::AutocompleteForPrefixes (on in-memory DB)
 //         -> HistoryService::ScheduleAutocomplete
 //         (return to controller) ----
 //                                   /
 //                              HistoryBackend::ScheduleAutocomplete
 //                                -> HistoryURLProvider::ExecuteWithDB
 //                                  -> DoAutocomplete
-//                                    -> URLDatabase::AutocompleteForPrefix
+//                                    -> URLDatabase::AutocompleteForPrefixes
 //                                /
 //   HistoryService::QueryComplete
 //     [params_ destroyed]
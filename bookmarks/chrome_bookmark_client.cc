@@ -144,11 +144,28 @@ void ChromeBookmarkClient::BookmarkNodeRemoved(
     int old_index,
     const BookmarkNode* node,
     const std::set<GURL>& removed_urls) {
-  NotifyHistoryOfRemovedURLs(profile_, removed_urls);
+  OnURLsRemoved(removed_urls);
 }
 
 void ChromeBookmarkClient::BookmarkAllNodesRemoved(
     BookmarkModel* model,
     const std::set<GURL>& removed_urls) {
+  OnURLsRemoved(removed_urls);
+}
+
+void ChromeBookmarkClient::ExtensiveBookmarkChangesEnded(
+    BookmarkModel* model) {
+  if (pending_removed_urls_.empty())
+    return;
+  std::set<GURL> removed_urls;
+  removed_urls.swap(pending_removed_urls_);
+  NotifyHistoryOfRemovedURLs(profile_, removed_urls);
+}
+
+void ChromeBookmarkClient::OnURLsRemoved(const std::set<GURL>& removed_urls) {
+  if (model_->IsDoingExtensiveChanges()) {
+    pending_removed_urls_.insert(removed_urls.begin(), removed_urls.end());
+    return;
+  }
   NotifyHistoryOfRemovedURLs(profile_, removed_urls);
 }
@@ -5,6 +5,8 @@
 #ifndef CHROME_BROWSER_BOOKMARKS_CHROME_BOOKMARK_CLIENT_H_
 #define CHROME_BROWSER_BOOKMARKS_CHROME_BOOKMARK_CLIENT_H_
 
+#include <set>
+
 #include "base/compiler_specific.h"
 #include "components/bookmarks/browser/base_bookmark_model_observer.h"
 #include "components/bookmarks/browser/bookmark_client.h"
@@ -62,9 +64,18 @@ class ChromeBookmarkClient : public BookmarkClient,
   virtual void BookmarkAllNodesRemoved(
       BookmarkModel* model,
       const std::set<GURL>& removed_urls) OVERRIDE;
+  virtual void ExtensiveBookmarkChangesEnded(BookmarkModel* model) OVERRIDE;
+
+  // Tells history that |removed_urls| are no longer bookmarked, or queues
+  // them until the model is done with extensive changes.
+  void OnURLsRemoved(const std::set<GURL>& removed_urls);
 
   Profile* profile_;
 
+  // URLs removed while the model is doing extensive changes. History is told
+  // about them at once when the changes end.
+  std::set<GURL> pending_removed_urls_;
+
   content::NotificationRegistrar registrar_;
 
   scoped_ptr<BookmarkModel> model_;
@@ -13,6 +13,7 @@
 #include "base/command_line.h"
 #include "base/debug/alias.h"
 #include "base/debug/leak_annotations.h"
+#include "base/debug/trace_event.h"
 #include "base/path_service.h"
 #include "base/prefs/json_pref_store.h"
 #include "base/prefs/pref_registry_simple.h"
@@ -924,6 +925,7 @@ void BrowserProcessImpl::PreMainMessageLoopRun() {
 }
 
 void BrowserProcessImpl::CreateIconManager() {
+  TRACE_EVENT0("browser", "BrowserProcessImpl::CreateIconManager");
   DCHECK(!created_icon_manager_ && icon_manager_.get() == NULL);
   created_icon_manager_ = true;
   icon_manager_.reset(new IconManager);
@@ -937,6 +939,7 @@ void BrowserProcessImpl::CreateIntranetRedirectDetector() {
 }
 
 void BrowserProcessImpl::CreateNotificationUIManager() {
+  TRACE_EVENT0("browser", "BrowserProcessImpl::CreateNotificationUIManager");
 #if defined(ENABLE_NOTIFICATIONS)
   DCHECK(notification_ui_manager_.get() == NULL);
   notification_ui_manager_.reset(NotificationUIManager::Create(local_state()));
@@ -957,6 +960,8 @@ void BrowserProcessImpl::CreateStatusTray() {
 }
 
 void BrowserProcessImpl::CreatePrintPreviewDialogController() {
+  TRACE_EVENT0("browser",
+               "BrowserProcessImpl::CreatePrintPreviewDialogController");
 #if defined(ENABLE_FULL_PRINTING)
   DCHECK(print_preview_dialog_controller_.get() == NULL);
   print_preview_dialog_controller_ =
@@ -967,6 +972,8 @@ void BrowserProcessImpl::CreatePrintPreviewDialogController() {
 }
 
 void BrowserProcessImpl::CreateBackgroundPrintingManager() {
+  TRACE_EVENT0("browser",
+               "BrowserProcessImpl::CreateBackgroundPrintingManager");
 #if defined(ENABLE_FULL_PRINTING)
   DCHECK(background_printing_manager_.get() == NULL);
   background_printing_manager_.reset(new printing::BackgroundPrintingManager());
@@ -976,6 +983,7 @@ void BrowserProcessImpl::CreateBackgroundPrintingManager() {
 }
 
 void BrowserProcessImpl::CreateSafeBrowsingService() {
+  TRACE_EVENT0("browser", "BrowserProcessImpl::CreateSafeBrowsingService");
   DCHECK(safe_browsing_service_.get() == NULL);
   // Set this flag to true so that we don't retry indefinitely to
   // create the service class if there was an error.
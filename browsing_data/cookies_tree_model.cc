@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <iterator>
 #include <vector>
 
 #include "base/bind.h"
@@ -523,26 +524,101 @@ CookieTreeRootNode::CookieTreeRootNode(CookiesTreeModel* model)
     : model_(model) {
 }
 
-CookieTreeRootNode::~CookieTreeRootNode() {}
+CookieTreeRootNode::~CookieTreeRootNode() {
+  // Attached host nodes are deleted along with the rest of the tree; the
+  // detached ones are only owned by the index.
+  for (HostNodeMap::iterator it = host_nodes_.begin();
+       it != host_nodes_.end(); ++it) {
+    if (!it->second->parent())
+      delete it->second;
+  }
+}
 
 CookieTreeHostNode* CookieTreeRootNode::GetOrCreateHostNode(
     const GURL& url) {
-  scoped_ptr<CookieTreeHostNode> host_node(
-      new CookieTreeHostNode(url));
+  // First see if there is an existing match, possibly hidden by the filter.
+  base::string16 title = CookieTreeHostNode::TitleForUrl(url);
+  HostNodeMap::iterator it = host_nodes_.find(title);
+  if (it != host_nodes_.end()) {
+    if (!it->second->parent())
+      AttachHostNode(it->second);
+    return it->second;
+  }
+  // Node doesn't exist, insert the new one into the (ordered) children.
+  CookieTreeHostNode* host_node = new CookieTreeHostNode(url);
+  host_nodes_[title] = host_node;
+  AttachHostNode(host_node);
+  return host_node;
+}
+
+void CookieTreeRootNode::UpdateFilter(const base::string16& filter) {
+  DCHECK(model_);
+  // When the new filter contains the old one, no detached node can start
+  // matching, so only the attached ones need to be looked at.
+  bool narrowing = filter.find(filter_) != base::string16::npos;
+  filter_ = filter;
+
+  std::vector<CookieTreeNode*> kept;
+  std::vector<CookieTreeNode*> old_children;
+  old_children.swap(children());
+  for (size_t i = 0; i < old_children.size(); ++i) {
+    if (old_children[i]->GetTitle().find(filter_) != base::string16::npos)
+      kept.push_back(old_children[i]);
+  }
+
+  std::vector<CookieTreeNode*> added;
+  if (!narrowing) {
+    for (HostNodeMap::iterator it = host_nodes_.begin();
+         it != host_nodes_.end(); ++it) {
+      if (!it->second->parent() &&
+          it->first.find(filter_) != base::string16::npos) {
+        added.push_back(it->second);
+      }
+    }
+    std::sort(added.begin(), added.end(), HostNodeComparator());
+  }
+
+  if (kept.size() == old_children.size() && added.empty()) {
+    old_children.swap(children());
+    return;
+  }
 
-  // First see if there is an existing match.
+  // Unparent every old child while it is the only child, so Remove() doesn't
+  // have to search or shift the children, then append the merged (ordered)
+  // result. This keeps widening or narrowing over many hosts linear.
+  for (size_t i = 0; i < old_children.size(); ++i) {
+    children().push_back(old_children[i]);
+    Remove(old_children[i]);
+  }
+  std::vector<CookieTreeNode*> merged;
+  merged.reserve(kept.size() + added.size());
+  std::merge(kept.begin(), kept.end(), added.begin(), added.end(),
+             std::back_inserter(merged), HostNodeComparator());
+  for (size_t i = 0; i < merged.size(); ++i)
+    Add(merged[i], child_count());
+
+  if (!old_children.empty()) {
+    model_->NotifyObserverTreeNodesRemoved(
+        this, 0, static_cast<int>(old_children.size()));
+  }
+  if (!merged.empty())
+    model_->NotifyObserverTreeNodesAdded(this, 0, child_count());
+}
+
+void CookieTreeRootNode::ForgetHostNode(CookieTreeHostNode* host_node) {
+  DCHECK_EQ(this, host_node->parent());
+  HostNodeMap::iterator it = host_nodes_.find(host_node->GetTitle());
+  DCHECK(it != host_nodes_.end() && it->second == host_node);
+  host_nodes_.erase(it);
+}
+
+void CookieTreeRootNode::AttachHostNode(CookieTreeHostNode* host_node) {
+  DCHECK(model_);
+  DCHECK(!host_node->parent());
   std::vector<CookieTreeNode*>::iterator host_node_iterator =
-        std::lower_bound(children().begin(), children().end(), host_node.get(),
+        std::lower_bound(children().begin(), children().end(), host_node,
                          HostNodeComparator());
-  if (host_node_iterator != children().end() &&
-      CookieTreeHostNode::TitleForUrl(url) ==
-      (*host_node_iterator)->GetTitle())
-    return static_cast<CookieTreeHostNode*>(*host_node_iterator);
-  // Node doesn't exist, insert the new one into the (ordered) children.
-  DCHECK(model_);
-  model_->Add(this, host_node.get(),
-              (host_node_iterator - children().begin()));
-  return host_node.release();
+  model_->Add(this, host_node, (host_node_iterator - children().begin()));
 }
 
 CookiesTreeModel* CookieTreeRootNode::GetModel() const {
@@ -925,11 +1001,15 @@ int CookiesTreeModel::GetIconIndex(ui::TreeModelNode* node) {
 
 void CookiesTreeModel::DeleteAllStoredObjects() {
   NotifyObserverBeginBatch();
-  CookieTreeNode* root = GetRoot();
+  CookieTreeRootNode* root = static_cast<CookieTreeRootNode*>(GetRoot());
   root->DeleteStoredObjects();
   int num_children = root->child_count();
-  for (int i = num_children - 1; i >= 0; --i)
-    delete Remove(root, root->GetChild(i));
+  for (int i = num_children - 1; i >= 0; --i) {
+    CookieTreeHostNode* host_node =
+        static_cast<CookieTreeHostNode*>(root->GetChild(i));
+    root->ForgetHostNode(host_node);
+    delete Remove(root, host_node);
+  }
   NotifyObserverTreeNodeChanged(root);
   NotifyObserverEndBatch();
 }
@@ -939,28 +1019,20 @@ void CookiesTreeModel::DeleteCookieNode(CookieTreeNode* cookie_node) {
     return;
   cookie_node->DeleteStoredObjects();
   CookieTreeNode* parent_node = cookie_node->parent();
+  if (parent_node == GetRoot()) {
+    static_cast<CookieTreeRootNode*>(parent_node)->ForgetHostNode(
+        static_cast<CookieTreeHostNode*>(cookie_node));
+  }
   delete Remove(parent_node, cookie_node);
   if (parent_node->empty())
     DeleteCookieNode(parent_node);
 }
 
 void CookiesTreeModel::UpdateSearchResults(const base::string16& filter) {
-  CookieTreeNode* root = GetRoot();
+  CookieTreeRootNode* root = static_cast<CookieTreeRootNode*>(GetRoot());
   ScopedBatchUpdateNotifier notifier(this, root);
-  int num_children = root->child_count();
   notifier.StartBatchUpdate();
-  for (int i = num_children - 1; i >= 0; --i)
-    delete Remove(root, root->GetChild(i));
-
-  PopulateCookieInfoWithFilter(data_container(), &notifier, filter);
-  PopulateDatabaseInfoWithFilter(data_container(), &notifier, filter);
-  PopulateLocalStorageInfoWithFilter(data_container(), &notifier, filter);
-  PopulateSessionStorageInfoWithFilter(data_container(), &notifier, filter);
-  PopulateAppCacheInfoWithFilter(data_container(), &notifier, filter);
-  PopulateIndexedDBInfoWithFilter(data_container(), &notifier, filter);
-  PopulateFileSystemInfoWithFilter(data_container(), &notifier, filter);
-  PopulateQuotaInfoWithFilter(data_container(), &notifier, filter);
-  PopulateServerBoundCertInfoWithFilter(data_container(), &notifier, filter);
+  root->UpdateFilter(filter);
 }
 
 const extensions::ExtensionSet* CookiesTreeModel::ExtensionsProtectingNode(
@@ -9,6 +9,7 @@
 // inline code (which shouldn't be inline).
 
 #include <list>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -169,13 +170,36 @@ class CookieTreeRootNode : public CookieTreeNode {
 
   CookieTreeHostNode* GetOrCreateHostNode(const GURL& url);
 
+  // Shows only the host nodes whose title contains |filter|. Host nodes that
+  // stop matching are detached from the tree but kept in the host index, so
+  // relaxing the filter later re-attaches them instead of rebuilding them.
+  void UpdateFilter(const base::string16& filter);
+
+  // Drops |host_node| from the host index. Must be called before the model
+  // deletes a host node that is attached to this root.
+  void ForgetHostNode(CookieTreeHostNode* host_node);
+
   // CookieTreeNode methods:
   virtual CookiesTreeModel* GetModel() const OVERRIDE;
   virtual DetailedInfo GetDetailedInfo() const OVERRIDE;
 
  private:
+  typedef std::map<base::string16, CookieTreeHostNode*> HostNodeMap;
+
+  // Inserts the detached |host_node| into the (ordered) children.
+  void AttachHostNode(CookieTreeHostNode* host_node);
+
   CookiesTreeModel* model_;
 
+  // Every host node known to the model, keyed by title. Nodes hidden by
+  // |filter_| have no parent and are owned by this map; the others are owned
+  // by the tree.
+  HostNodeMap host_nodes_;
+
+  // The filter last passed to UpdateFilter(). No detached host node's title
+  // contains it.
+  base::string16 filter_;
+
   DISALLOW_COPY_AND_ASSIGN(CookieTreeRootNode);
 };
 
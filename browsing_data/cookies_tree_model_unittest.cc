@@ -8,6 +8,8 @@
 
 #include "base/message_loop/message_loop.h"
 #include "base/prefs/pref_service.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
 #include "chrome/browser/browsing_data/mock_browsing_data_appcache_helper.h"
 #include "chrome/browser/browsing_data/mock_browsing_data_cookie_helper.h"
 #include "chrome/browser/browsing_data/mock_browsing_data_database_helper.h"
@@ -28,6 +30,7 @@
 #include "net/url_request/url_request_context.h"
 #include "net/url_request/url_request_context_getter.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
 
 #include "base/strings/utf_string_conversions.h"
 
@@ -1191,4 +1194,110 @@ TEST_F(CookiesTreeModelTest, CookiesFilter) {
   EXPECT_EQ("A,B,C,D", GetDisplayedCookies(&cookies_model));
 }
 
+TEST_F(CookiesTreeModelTest, FilterKeepsHostNodes) {
+  LocalDataContainer* container =
+      new LocalDataContainer(mock_browsing_data_cookie_helper_.get(),
+                             mock_browsing_data_database_helper_.get(),
+                             mock_browsing_data_local_storage_helper_.get(),
+                             mock_browsing_data_session_storage_helper_.get(),
+                             mock_browsing_data_appcache_helper_.get(),
+                             mock_browsing_data_indexed_db_helper_.get(),
+                             mock_browsing_data_file_system_helper_.get(),
+                             mock_browsing_data_quota_helper_.get(),
+                             mock_browsing_data_server_bound_cert_helper_.get(),
+                             mock_browsing_data_flash_lso_helper_.get());
+  CookiesTreeModel cookies_model(
+      container, special_storage_policy_.get(), false);
+
+  mock_browsing_data_cookie_helper_->
+      AddCookieSamples(GURL("http://123.com"), "A=1");
+  mock_browsing_data_cookie_helper_->
+      AddCookieSamples(GURL("http://foo1.com"), "B=1");
+  mock_browsing_data_cookie_helper_->
+      AddCookieSamples(GURL("http://foo2.com"), "C=1");
+  mock_browsing_data_cookie_helper_->Notify();
+  CookieTreeNode* root = cookies_model.GetRoot();
+  ASSERT_EQ(3, root->child_count());
+  CookieTreeNode* foo2 = root->GetChild(2);
+  EXPECT_EQ(base::ASCIIToUTF16("foo2.com"), foo2->GetTitle());
+
+  // Narrowing and widening the filter reuses the same host nodes.
+  cookies_model.UpdateSearchResults(base::ASCIIToUTF16("f"));
+  EXPECT_EQ("B,C", GetDisplayedCookies(&cookies_model));
+  cookies_model.UpdateSearchResults(base::ASCIIToUTF16("foo2"));
+  EXPECT_EQ("C", GetDisplayedCookies(&cookies_model));
+  EXPECT_EQ(foo2, root->GetChild(0));
+  cookies_model.UpdateSearchResults(base::string16());
+  EXPECT_EQ("A,B,C", GetDisplayedCookies(&cookies_model));
+  EXPECT_EQ(foo2, root->GetChild(2));
+
+  // Deleting a host while a filter is active must not bring it back once the
+  // filter is cleared.
+  cookies_model.UpdateSearchResults(base::ASCIIToUTF16("foo"));
+  cookies_model.DeleteCookieNode(root->GetChild(1));
+  EXPECT_EQ("B", GetDisplayedCookies(&cookies_model));
+  cookies_model.UpdateSearchResults(base::ASCIIToUTF16("foo1"));
+  cookies_model.DeleteAllStoredObjects();
+  EXPECT_EQ("", GetDisplayedCookies(&cookies_model));
+  cookies_model.UpdateSearchResults(base::string16());
+  EXPECT_EQ("A", GetDisplayedCookies(&cookies_model));
+  EXPECT_EQ(1, root->child_count());
+}
+
+// This is manual as it builds a model with 50000 hosts and only reports
+// timings; FilterKeepsHostNodes covers the behavior.
+TEST_F(CookiesTreeModelTest, MANUAL_FilterTypingPerf) {
+  const int kHostCount = 50000;
+  const std::string kQuery = "host19";
+
+  LocalDataContainer* container =
+      new LocalDataContainer(mock_browsing_data_cookie_helper_.get(),
+                             mock_browsing_data_database_helper_.get(),
+                             mock_browsing_data_local_storage_helper_.get(),
+                             mock_browsing_data_session_storage_helper_.get(),
+                             mock_browsing_data_appcache_helper_.get(),
+                             mock_browsing_data_indexed_db_helper_.get(),
+                             mock_browsing_data_file_system_helper_.get(),
+                             mock_browsing_data_quota_helper_.get(),
+                             mock_browsing_data_server_bound_cert_helper_.get(),
+                             mock_browsing_data_flash_lso_helper_.get());
+  CookiesTreeModel cookies_model(
+      container, special_storage_policy_.get(), false);
+  for (int i = 0; i < kHostCount; ++i) {
+    mock_browsing_data_cookie_helper_->AddCookieSamples(
+        GURL("http://host" + base::IntToString(i) + ".com"), "A=1");
+  }
+  mock_browsing_data_cookie_helper_->Notify();
+  ASSERT_EQ(kHostCount, cookies_model.GetRoot()->child_count());
+
+  // Type the query one character at a time, then erase it again.
+  int keystrokes = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (size_t i = 1; i <= kQuery.size(); ++i, ++keystrokes)
+    cookies_model.UpdateSearchResults(base::ASCIIToUTF16(kQuery.substr(0, i)));
+  EXPECT_EQ(1111, cookies_model.GetRoot()->child_count());
+  for (size_t i = kQuery.size(); i-- > 0; ++keystrokes)
+    cookies_model.UpdateSearchResults(base::ASCIIToUTF16(kQuery.substr(0, i)));
+  const base::TimeDelta typing_elapsed = base::TimeTicks::Now() - start;
+  EXPECT_EQ(kHostCount, cookies_model.GetRoot()->child_count());
+
+  // Clear the search box in one go from a narrow query, which re-attaches
+  // nearly every host.
+  cookies_model.UpdateSearchResults(base::ASCIIToUTF16(kQuery));
+  start = base::TimeTicks::Now();
+  cookies_model.UpdateSearchResults(base::string16());
+  const base::TimeDelta clear_elapsed = base::TimeTicks::Now() - start;
+  ASSERT_EQ(kHostCount, cookies_model.GetRoot()->child_count());
+  EXPECT_EQ(base::ASCIIToUTF16("host0.com"),
+            cookies_model.GetRoot()->GetChild(0)->GetTitle());
+
+  perf_test::PrintResult(
+      "cookies_tree_model", "", "filter_time_per_keystroke",
+      typing_elapsed.InMicroseconds() / static_cast<double>(keystrokes), "us",
+      true);
+  perf_test::PrintResult(
+      "cookies_tree_model", "", "filter_clear_time",
+      static_cast<double>(clear_elapsed.InMicroseconds()), "us", true);
+}
+
 }  // namespace
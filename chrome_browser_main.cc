@@ -450,6 +450,33 @@ bool ProcessSingletonNotificationCallback(
       command_line, current_directory, startup_profile_dir);
   return true;
 }
+
+// Returns the exit code of a process that handed its command line to an
+// already running browser.
+int ProcessNotifiedResultCode(const CommandLine& command_line) {
+#if defined(OS_POSIX) && !defined(OS_MACOSX)
+  printf("%s\n", base::SysWideToNativeMB(base::UTF16ToWide(
+      l10n_util::GetStringUTF16(IDS_USED_EXISTING_BROWSER))).c_str());
+#endif
+  // Having a differentiated return type for testing allows for tests to
+  // verify proper handling of some switches. When not testing, stick to
+  // the standard Unix convention of returning zero when things went as
+  // expected.
+  if (command_line.HasSwitch(switches::kTestType))
+    return chrome::RESULT_CODE_NORMAL_EXIT_PROCESS_NOTIFIED;
+  return content::RESULT_CODE_NORMAL_EXIT;
+}
+
+#if defined(OS_POSIX) && !defined(OS_MACOSX)
+// Returns true if |command_line| can be handed to a running browser before
+// this process initializes. Switches that this process handles by itself
+// before looking for a running browser rule that out.
+bool CanNotifyRunningProcessEarly(const CommandLine& command_line) {
+  return !command_line.HasSwitch(switches::kMakeDefaultBrowser) &&
+         !command_line.HasSwitch(switches::kPackExtension) &&
+         !command_line.HasSwitch(switches::kCheckCloudPrintConnectorPolicy);
+}
+#endif
 #endif  // !defined(OS_ANDROID)
 
 void LaunchDevToolsHandlerIfNeeded(const CommandLine& command_line) {
@@ -1058,6 +1085,22 @@ void ChromeBrowserMainParts::PostBrowserStart() {
 
 int ChromeBrowserMainParts::PreMainMessageLoopRunImpl() {
   TRACE_EVENT0("startup", "ChromeBrowserMainParts::PreMainMessageLoopRunImpl");
+#if defined(OS_POSIX) && !defined(OS_MACOSX) && !defined(OS_ANDROID)
+  // Opening a link from another application into a running browser should
+  // not wait for this process to initialize, so try to hand the command line
+  // over right away. If that doesn't work, the regular
+  // NotifyOtherProcessOrCreate() call below deals with locks and browsers
+  // that are still starting.
+  if (CanNotifyRunningProcessEarly(parsed_command_line())) {
+    TRACE_EVENT0("startup",
+                 "ChromeBrowserMainParts::NotifyRunningProcessFastPath");
+    if (process_singleton_->NotifyRunningProcessFastPath(
+            parsed_command_line()) == ProcessSingleton::PROCESS_NOTIFIED) {
+      notify_result_ = ProcessSingleton::PROCESS_NOTIFIED;
+      return ProcessNotifiedResultCode(parsed_command_line());
+    }
+  }
+#endif
   // Android updates the metrics service dynamically depending on whether the
   // application is in the foreground or not. Do not start here.
 #if !defined(OS_ANDROID)
@@ -1134,17 +1177,7 @@ int ChromeBrowserMainParts::PreMainMessageLoopRunImpl() {
         break;
 
       case ProcessSingleton::PROCESS_NOTIFIED:
-#if defined(OS_POSIX) && !defined(OS_MACOSX)
-        printf("%s\n", base::SysWideToNativeMB(base::UTF16ToWide(
-            l10n_util::GetStringUTF16(IDS_USED_EXISTING_BROWSER))).c_str());
-#endif
-        // Having a differentiated return type for testing allows for tests to
-        // verify proper handling of some switches. When not testing, stick to
-        // the standard Unix convention of returning zero when things went as
-        // expected.
-        if (parsed_command_line().HasSwitch(switches::kTestType))
-          return chrome::RESULT_CODE_NORMAL_EXIT_PROCESS_NOTIFIED;
-        return content::RESULT_CODE_NORMAL_EXIT;
+        return ProcessNotifiedResultCode(parsed_command_line());
 
       case ProcessSingleton::PROFILE_IN_USE:
         return chrome::RESULT_CODE_PROFILE_IN_USE;
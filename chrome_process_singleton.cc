@@ -34,6 +34,14 @@ ProcessSingleton::NotifyResult
   return process_singleton_.NotifyOtherProcessOrCreate();
 }
 
+#if defined(OS_POSIX) && !defined(OS_ANDROID)
+ProcessSingleton::NotifyResult
+    ChromeProcessSingleton::NotifyRunningProcessFastPath(
+        const base::CommandLine& command_line) {
+  return process_singleton_.NotifyRunningProcessFastPath(command_line);
+}
+#endif
+
 void ChromeProcessSingleton::Cleanup() {
   process_singleton_.Cleanup();
 }
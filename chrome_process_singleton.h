@@ -47,6 +47,12 @@ class ChromeProcessSingleton {
   // unreachable process).
   ProcessSingleton::NotifyResult NotifyOtherProcessOrCreate();
 
+#if defined(OS_POSIX) && !defined(OS_ANDROID)
+  // See ProcessSingleton::NotifyRunningProcessFastPath().
+  ProcessSingleton::NotifyResult NotifyRunningProcessFastPath(
+      const base::CommandLine& command_line);
+#endif
+
   // Clear any lock state during shutdown.
   void Cleanup();
 
@@ -8,11 +8,13 @@
 
 #include "ash/wm/window_state.h"
 #include "ash/wm/window_util.h"
+#include "base/bind.h"
 #include "base/command_line.h"
 #include "base/logging.h"
 #include "base/prefs/pref_service.h"
 #include "base/strings/string_util.h"
 #include "base/sys_info.h"
+#include "chrome/browser/chrome_notification_types.h"
 #include "chrome/browser/chromeos/login/ui/login_display_host_impl.h"
 #include "chrome/browser/chromeos/login/users/user_manager.h"
 #include "chrome/browser/profiles/profile_manager.h"
@@ -20,6 +22,8 @@
 #include "chromeos/chromeos_switches.h"
 #include "chromeos/ime/ime_keyboard.h"
 #include "chromeos/ime/input_method_manager.h"
+#include "content/public/browser/notification_service.h"
+#include "content/public/browser/notification_source.h"
 #include "ui/events/event.h"
 #include "ui/events/event_utils.h"
 #include "ui/events/keycodes/keyboard_code_conversion.h"
@@ -76,14 +80,15 @@ const struct ModifierRemapping {
 
 const ModifierRemapping* kModifierRemappingCtrl = &kModifierRemappings[1];
 
-// Gets a remapped key for |pref_name| key. For example, to find out which
-// key Search is currently remapped to, call the function with
-// prefs::kLanguageRemapSearchKeyTo.
-const ModifierRemapping* GetRemappedKey(const std::string& pref_name,
+// Gets a remapped key for |pref_name| key from |pref_service|. For example,
+// to find out which key Search is currently remapped to, call the function
+// with prefs::kLanguageRemapSearchKeyTo. Used only to compile the
+// EventRewriter::RemappingTable, not per event.
+const ModifierRemapping* GetRemappedKey(const char* pref_name,
                                         const PrefService& pref_service) {
-  if (!pref_service.FindPreference(pref_name.c_str()))
+  if (!pref_service.FindPreference(pref_name))
     return NULL;  // The |pref_name| hasn't been registered. On login screen?
-  const int value = pref_service.GetInteger(pref_name.c_str());
+  const int value = pref_service.GetInteger(pref_name);
   for (size_t i = 0; i < arraysize(kModifierRemappings); ++i) {
     if (value == kModifierRemappings[i].remap_to)
       return &kModifierRemappings[i];
@@ -155,10 +160,47 @@ void UpdateX11EventMask(int ui_flags, unsigned int* x_flags) {
 
 }  // namespace
 
+struct EventRewriter::RemappingTable {
+  // Returns the key that the modifier key with remapping pref |pref_name| is
+  // remapped to, or NULL if it is not remapped. |pref_name| must be one of
+  // the pref name constants used in |kModifierRemappings|.
+  const ModifierRemapping* GetRemappedKey(const char* pref_name) const {
+    for (size_t i = 0; i < arraysize(kModifierRemappings); ++i) {
+      if (kModifierRemappings[i].pref_name == pref_name)
+        return remapped_keys[i];
+    }
+    NOTREACHED() << pref_name;
+    return NULL;
+  }
+
+  // Indexed in parallel with |kModifierRemappings|; the key each entry is
+  // remapped to by its pref, or NULL.
+  const ModifierRemapping* remapped_keys[arraysize(kModifierRemappings)];
+
+  // The value of prefs::kLanguageSendFunctionKeys.
+  bool send_function_keys;
+};
+
 EventRewriter::EventRewriter()
     : last_device_id_(kBadDeviceId),
+      last_device_is_apple_keyboard_(false),
       ime_keyboard_for_testing_(NULL),
-      pref_service_for_testing_(NULL) {
+      pref_service_for_testing_(NULL),
+      active_profile_(NULL),
+      active_profile_is_stale_(true),
+      remapping_profile_(NULL),
+      remapping_pref_service_(NULL) {
+  registrar_.Add(this,
+                 chrome::NOTIFICATION_PROFILE_CREATED,
+                 content::NotificationService::AllSources());
+  registrar_.Add(this,
+                 chrome::NOTIFICATION_PROFILE_DESTROYED,
+                 content::NotificationService::AllSources());
+  registrar_.Add(this,
+                 chrome::NOTIFICATION_LOGIN_USER_PROFILE_PREPARED,
+                 content::NotificationService::AllSources());
+  if (UserManager::IsInitialized())
+    UserManager::Get()->AddSessionStateObserver(this);
 #if defined(USE_X11)
   ui::PlatformEventSource::GetInstance()->AddPlatformEventObserver(this);
   if (base::SysInfo::IsRunningOnChromeOS()) {
@@ -168,6 +210,8 @@ EventRewriter::EventRewriter()
 }
 
 EventRewriter::~EventRewriter() {
+  if (UserManager::IsInitialized())
+    UserManager::Get()->RemoveSessionStateObserver(this);
 #if defined(USE_X11)
   ui::PlatformEventSource::GetInstance()->RemovePlatformEventObserver(this);
   if (base::SysInfo::IsRunningOnChromeOS()) {
@@ -230,44 +274,121 @@ void EventRewriter::DeviceKeyPressedOrReleased(int device_id) {
     // booting the OS. Query the name of the device and add it to the map.
     DeviceAdded(device_id);
   }
-  last_device_id_ = device_id;
+  if (device_id != last_device_id_)
+    SetLastDeviceId(device_id);
 }
 #endif
 
-const PrefService* EventRewriter::GetPrefService() const {
-  if (pref_service_for_testing_)
-    return pref_service_for_testing_;
-  Profile* profile = ProfileManager::GetActiveUserProfile();
-  return profile ? profile->GetPrefs() : NULL;
-}
-
-bool EventRewriter::IsAppleKeyboard() const {
+void EventRewriter::SetLastDeviceId(int device_id) {
+  last_device_id_ = device_id;
+  last_device_is_apple_keyboard_ = false;
   if (last_device_id_ == kBadDeviceId)
-    return false;
+    return;
 
-  // Check which device generated |event|.
   std::map<int, DeviceType>::const_iterator iter =
       device_id_to_type_.find(last_device_id_);
   if (iter == device_id_to_type_.end()) {
     LOG(ERROR) << "Device ID " << last_device_id_ << " is unknown.";
-    return false;
+    return;
+  }
+
+  last_device_is_apple_keyboard_ = iter->second == kDeviceAppleKeyboard;
+}
+
+void EventRewriter::Observe(int type,
+                            const content::NotificationSource& source,
+                            const content::NotificationDetails& details) {
+  switch (type) {
+    case chrome::NOTIFICATION_PROFILE_DESTROYED:
+      // The profile's PrefService goes away with it.
+      if (content::Source<Profile>(source).ptr() == remapping_profile_)
+        ResetRemappingTable();
+      active_profile_is_stale_ = true;
+      break;
+    case chrome::NOTIFICATION_PROFILE_CREATED:
+    case chrome::NOTIFICATION_LOGIN_USER_PROFILE_PREPARED:
+      active_profile_is_stale_ = true;
+      break;
+    default:
+      NOTREACHED();
+  }
+}
+
+void EventRewriter::ActiveUserChanged(const User* active_user) {
+  active_profile_is_stale_ = true;
+}
+
+Profile* EventRewriter::GetActiveProfile() {
+  if (active_profile_is_stale_) {
+    // Cleared first, as the lookup may create a profile and so notify again.
+    active_profile_is_stale_ = false;
+    active_profile_ = ProfileManager::GetActiveUserProfile();
+  }
+  return active_profile_;
+}
+
+const EventRewriter::RemappingTable* EventRewriter::GetRemappingTable() {
+  Profile* profile = NULL;
+  PrefService* pref_service = pref_service_for_testing_;
+  if (!pref_service) {
+    profile = GetActiveProfile();
+    pref_service = profile ? profile->GetPrefs() : NULL;
   }
 
-  const DeviceType type = iter->second;
-  return type == kDeviceAppleKeyboard;
+  if (profile != remapping_profile_ ||
+      pref_service != remapping_pref_service_) {
+    // The active profile has changed; watch the new profile's prefs instead.
+    ResetRemappingTable();
+    if (!pref_service)
+      return NULL;
+    remapping_profile_ = profile;
+    remapping_pref_service_ = pref_service;
+    pref_change_registrar_.reset(new PrefChangeRegistrar);
+    pref_change_registrar_->Init(pref_service);
+    base::Closure callback = base::Bind(&EventRewriter::UpdateRemappingTable,
+                                        base::Unretained(this));
+    for (size_t i = 0; i < arraysize(kModifierRemappings); ++i) {
+      if (kModifierRemappings[i].pref_name)
+        pref_change_registrar_->Add(kModifierRemappings[i].pref_name, callback);
+    }
+    pref_change_registrar_->Add(prefs::kLanguageSendFunctionKeys, callback);
+    UpdateRemappingTable();
+  }
+  return remapping_table_.get();
 }
 
-bool EventRewriter::TopRowKeysAreFunctionKeys(const ui::KeyEvent& event) const {
-  const PrefService* prefs = GetPrefService();
-  if (prefs && prefs->FindPreference(prefs::kLanguageSendFunctionKeys) &&
-      prefs->GetBoolean(prefs::kLanguageSendFunctionKeys))
+void EventRewriter::ResetRemappingTable() {
+  pref_change_registrar_.reset();
+  remapping_profile_ = NULL;
+  remapping_pref_service_ = NULL;
+  remapping_table_.reset();
+}
+
+void EventRewriter::UpdateRemappingTable() {
+  DCHECK(remapping_pref_service_);
+  if (!remapping_table_)
+    remapping_table_.reset(new RemappingTable);
+  for (size_t i = 0; i < arraysize(kModifierRemappings); ++i) {
+    const char* pref_name = kModifierRemappings[i].pref_name;
+    remapping_table_->remapped_keys[i] =
+        pref_name ? GetRemappedKey(pref_name, *remapping_pref_service_) : NULL;
+  }
+  remapping_table_->send_function_keys =
+      remapping_pref_service_->FindPreference(
+          prefs::kLanguageSendFunctionKeys) &&
+      remapping_pref_service_->GetBoolean(prefs::kLanguageSendFunctionKeys);
+}
+
+bool EventRewriter::TopRowKeysAreFunctionKeys(const ui::KeyEvent& event) {
+  const RemappingTable* table = GetRemappingTable();
+  if (table && table->send_function_keys)
     return true;
 
   ash::wm::WindowState* state = ash::wm::GetActiveWindowState();
   return state ? state->top_row_keys_are_function_keys() : false;
 }
 
-int EventRewriter::GetRemappedModifierMasks(const PrefService& pref_service,
+int EventRewriter::GetRemappedModifierMasks(const RemappingTable& table,
                                             const ui::Event& event,
                                             int original_flags) const {
   int unmodified_flags = original_flags;
@@ -299,10 +420,8 @@ int EventRewriter::GetRemappedModifierMasks(const PrefService& pref_service,
       default:
         break;
     }
-    if (!remapped_key && kModifierRemappings[i].pref_name) {
-      remapped_key =
-          GetRemappedKey(kModifierRemappings[i].pref_name, pref_service);
-    }
+    if (!remapped_key)
+      remapped_key = table.remapped_keys[i];
     if (remapped_key) {
       unmodified_flags &= ~kModifierRemappings[i].flag;
       rewritten_flags |= remapped_key->flag;
@@ -441,8 +560,8 @@ void EventRewriter::RewriteModifierKeys(const ui::KeyEvent& key_event,
       LoginDisplayHostImpl::default_host())
     return;
 
-  const PrefService* pref_service = GetPrefService();
-  if (!pref_service)
+  const RemappingTable* table = GetRemappingTable();
+  if (!table)
     return;
 
   MutableKeyState incoming = *state;
@@ -459,8 +578,7 @@ void EventRewriter::RewriteModifierKeys(const ui::KeyEvent& key_event,
       // key is not shown. Therefore, ignore the kLanguageRemapDiamondKeyTo
       // syncable pref.
       if (HasDiamondKey())
-        remapped_key =
-            GetRemappedKey(prefs::kLanguageRemapDiamondKeyTo, *pref_service);
+        remapped_key = table->GetRemappedKey(prefs::kLanguageRemapDiamondKeyTo);
       // Default behavior is Ctrl key.
       if (!remapped_key) {
         DCHECK_EQ(ui::VKEY_CONTROL, kModifierRemappingCtrl->key_code);
@@ -474,8 +592,7 @@ void EventRewriter::RewriteModifierKeys(const ui::KeyEvent& key_event,
     // XK_ISO_Level3_Shift with Mod3Mask, not XF86XK_Launch7).
     case ui::VKEY_F16:
       characteristic_flag = ui::EF_CAPS_LOCK_DOWN;
-      remapped_key =
-          GetRemappedKey(prefs::kLanguageRemapCapsLockKeyTo, *pref_service);
+      remapped_key = table->GetRemappedKey(prefs::kLanguageRemapCapsLockKeyTo);
       break;
     case ui::VKEY_LWIN:
     case ui::VKEY_RWIN:
@@ -485,22 +602,19 @@ void EventRewriter::RewriteModifierKeys(const ui::KeyEvent& key_event,
         DCHECK_EQ(ui::VKEY_CONTROL, kModifierRemappingCtrl->key_code);
         remapped_key = kModifierRemappingCtrl;
       } else {
-        remapped_key =
-            GetRemappedKey(prefs::kLanguageRemapSearchKeyTo, *pref_service);
+        remapped_key = table->GetRemappedKey(prefs::kLanguageRemapSearchKeyTo);
       }
       // Default behavior is Super key, hence don't remap the event if the pref
       // is unavailable.
       break;
     case ui::VKEY_CONTROL:
       characteristic_flag = ui::EF_CONTROL_DOWN;
-      remapped_key =
-          GetRemappedKey(prefs::kLanguageRemapControlKeyTo, *pref_service);
+      remapped_key = table->GetRemappedKey(prefs::kLanguageRemapControlKeyTo);
       break;
     case ui::VKEY_MENU:
       // ALT key
       characteristic_flag = ui::EF_ALT_DOWN;
-      remapped_key =
-          GetRemappedKey(prefs::kLanguageRemapAltKeyTo, *pref_service);
+      remapped_key = table->GetRemappedKey(prefs::kLanguageRemapAltKeyTo);
       break;
     default:
       break;
@@ -513,8 +627,7 @@ void EventRewriter::RewriteModifierKeys(const ui::KeyEvent& key_event,
   }
 
   // Next, remap modifier bits.
-  state->flags |=
-      GetRemappedModifierMasks(*pref_service, key_event, incoming.flags);
+  state->flags |= GetRemappedModifierMasks(*table, key_event, incoming.flags);
   if (key_event.type() == ui::ET_KEY_PRESSED)
     state->flags |= characteristic_flag;
   else
@@ -714,12 +827,12 @@ void EventRewriter::RewriteFunctionKeys(const ui::KeyEvent& key_event,
 
 void EventRewriter::RewriteLocatedEvent(const ui::Event& event,
                                         int* flags) {
-  const PrefService* pref_service = GetPrefService();
-  if (!pref_service)
+  const RemappingTable* table = GetRemappingTable();
+  if (!table)
     return;
 
   // First, remap modifier masks.
-  *flags = GetRemappedModifierMasks(*pref_service, event, *flags);
+  *flags = GetRemappedModifierMasks(*table, event, *flags);
 
 #if defined(USE_X11)
   // TODO(kpschoedel): de-X11 with unified device ids from crbug.com/360377
@@ -765,6 +878,8 @@ EventRewriter::DeviceType EventRewriter::DeviceAddedInternal(
   // Always overwrite the existing device_id since the X server may reuse a
   // device id for an unattached device.
   device_id_to_type_[device_id] = type;
+  if (device_id == last_device_id_)
+    SetLastDeviceId(device_id);
   return type;
 }
 
@@ -817,6 +932,8 @@ void EventRewriter::DeviceAdded(int device_id) {
 
 void EventRewriter::DeviceRemoved(int device_id) {
   device_id_to_type_.erase(device_id);
+  if (device_id == last_device_id_)
+    SetLastDeviceId(device_id);
 }
 #endif
 
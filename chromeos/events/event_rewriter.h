@@ -12,6 +12,10 @@
 #include "base/compiler_specific.h"
 #include "base/containers/hash_tables.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/prefs/pref_change_registrar.h"
+#include "chrome/browser/chromeos/login/users/user_manager.h"
+#include "content/public/browser/notification_observer.h"
+#include "content/public/browser/notification_registrar.h"
 #include "ui/events/event.h"
 #include "ui/events/event_rewriter.h"
 
@@ -22,6 +26,7 @@ typedef union _XEvent XEvent;
 #endif
 
 class PrefService;
+class Profile;
 
 namespace chromeos {
 namespace input_method {
@@ -44,6 +49,8 @@ class EventRewriter
       public DeviceHierarchyObserver,
       public ui::PlatformEventObserver,
 #endif
+      public content::NotificationObserver,
+      public UserManager::UserSessionStateObserver,
       public ui::EventRewriter {
  public:
   enum DeviceType {
@@ -68,9 +75,9 @@ class EventRewriter
 #endif
 
   void set_last_device_id_for_testing(int device_id) {
-    last_device_id_ = device_id;
+    SetLastDeviceId(device_id);
   }
-  void set_pref_service_for_testing(const PrefService* pref_service) {
+  void set_pref_service_for_testing(PrefService* pref_service) {
     pref_service_for_testing_ = pref_service;
   }
   void set_ime_keyboard_for_testing(
@@ -112,29 +119,59 @@ class EventRewriter
     int output_flags;
   };
 
+  // The modifier remappings selected by user preferences, compiled so that
+  // rewriting an event needs no pref lookups. Defined in the .cc file.
+  struct RemappingTable;
+
 #if defined(USE_X11)
   void DeviceKeyPressedOrReleased(int device_id);
 #endif
 
-  // Returns the PrefService that should be used.
-  const PrefService* GetPrefService() const;
+  // Sets |last_device_id_| and caches whether it is an Apple keyboard.
+  void SetLastDeviceId(int device_id);
+
+  // content::NotificationObserver:
+  virtual void Observe(int type,
+                       const content::NotificationSource& source,
+                       const content::NotificationDetails& details) OVERRIDE;
+
+  // UserManager::UserSessionStateObserver:
+  virtual void ActiveUserChanged(const User* active_user) OVERRIDE;
+
+  // Returns the profile whose prefs select the remappings, looking it up
+  // again only after a login or profile notification has cleared
+  // |active_profile_is_stale_|.
+  Profile* GetActiveProfile();
+
+  // Returns the remapping table for the PrefService that should be used,
+  // recompiling it if that PrefService has changed since the last event, or
+  // NULL if there is no PrefService.
+  const RemappingTable* GetRemappingTable();
+
+  // Stops watching |remapping_pref_service_| and drops the table compiled
+  // from it.
+  void ResetRemappingTable();
+
+  // Recompiles |remapping_table_| from |remapping_pref_service_|. Called
+  // when one of the remapping prefs changes.
+  void UpdateRemappingTable();
 
   // Checks the type of the |device_name|, and inserts a new entry to
   // |device_id_to_type_|.
   DeviceType DeviceAddedInternal(int device_id, const std::string& device_name);
 
   // Returns true if |last_device_id_| is Apple's.
-  bool IsAppleKeyboard() const;
+  bool IsAppleKeyboard() const { return last_device_is_apple_keyboard_; }
 
   // Returns true if the target for |event| would prefer to receive raw function
   // keys instead of having them rewritten into back, forward, brightness,
   // volume, etc. or if the user has specified that they desire top-row keys to
   // be treated as function keys globally.
-  bool TopRowKeysAreFunctionKeys(const ui::KeyEvent& event) const;
+  bool TopRowKeysAreFunctionKeys(const ui::KeyEvent& event);
 
   // Given modifier flags |original_flags|, returns the remapped modifiers
-  // according to user preferences and/or event properties.
-  int GetRemappedModifierMasks(const PrefService& pref_service,
+  // according to |table| and/or event properties.
+  int GetRemappedModifierMasks(const RemappingTable& table,
                                const ui::Event& event,
                                int original_flags) const;
 
@@ -171,9 +208,27 @@ class EventRewriter
 
   std::map<int, DeviceType> device_id_to_type_;
   int last_device_id_;
+  bool last_device_is_apple_keyboard_;
 
   chromeos::input_method::ImeKeyboard* ime_keyboard_for_testing_;
-  const PrefService* pref_service_for_testing_;
+  PrefService* pref_service_for_testing_;
+
+  // The last result of ProfileManager::GetActiveUserProfile(), which is too
+  // slow to call for every event. It is looked up again when the active user
+  // changes or a profile is created or destroyed.
+  Profile* active_profile_;
+  bool active_profile_is_stale_;
+
+  // The profile and PrefService |remapping_table_| was compiled from, and the
+  // registrar that keeps the table up to date with it. |remapping_profile_| is
+  // NULL when using |pref_service_for_testing_|. All three are reset when the
+  // profile is destroyed.
+  Profile* remapping_profile_;
+  PrefService* remapping_pref_service_;
+  scoped_ptr<PrefChangeRegistrar> pref_change_registrar_;
+  scoped_ptr<RemappingTable> remapping_table_;
+
+  content::NotificationRegistrar registrar_;
 
   DISALLOW_COPY_AND_ASSIGN(EventRewriter);
 };
@@ -0,0 +1,72 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+
+#include "base/prefs/pref_service.h"
+#include "base/time/time.h"
+#include "chrome/browser/chromeos/events/event_rewriter.h"
+#include "chrome/browser/profiles/profile.h"
+#include "chrome/browser/profiles/profile_manager.h"
+#include "chrome/common/pref_names.h"
+#include "chrome/test/base/in_process_browser_test.h"
+#include "chromeos/ime/ime_keyboard.h"
+#include "testing/perf/perf_test.h"
+#include "ui/events/event.h"
+
+namespace chromeos {
+
+typedef InProcessBrowserTest EventRewriterPerfBrowserTest;
+
+// Measures how many key events per second go through the rewriter with
+// several modifiers remapped in the active user's prefs, the way the
+// rewriter finds them in production. This is manual as it only reports a
+// timing.
+IN_PROC_BROWSER_TEST_F(EventRewriterPerfBrowserTest,
+                       MANUAL_RewriteKeyEventThroughput) {
+  Profile* profile = ProfileManager::GetActiveUserProfile();
+  ASSERT_TRUE(profile);
+  PrefService* prefs = profile->GetPrefs();
+  prefs->SetInteger(prefs::kLanguageRemapSearchKeyTo,
+                    input_method::kControlKey);
+  prefs->SetInteger(prefs::kLanguageRemapAltKeyTo, input_method::kSearchKey);
+
+  EventRewriter rewriter;
+  rewriter.DeviceAddedForTesting(0, "PC Keyboard");
+  rewriter.set_last_device_id_for_testing(0);
+
+  const ui::KeyEvent events[] = {
+      ui::KeyEvent(ui::ET_KEY_PRESSED, ui::VKEY_LWIN, ui::EF_COMMAND_DOWN,
+                   false),
+      ui::KeyEvent(ui::ET_KEY_PRESSED, ui::VKEY_A,
+                   ui::EF_COMMAND_DOWN | ui::EF_ALT_DOWN, false),
+      ui::KeyEvent(ui::ET_KEY_RELEASED, ui::VKEY_A, ui::EF_COMMAND_DOWN,
+                   false),
+      ui::KeyEvent(ui::ET_KEY_PRESSED, ui::VKEY_F5, ui::EF_NONE, false),
+      ui::KeyEvent(ui::ET_KEY_RELEASED, ui::VKEY_LWIN, ui::EF_NONE, false),
+  };
+
+  // Make sure the remappings come from the active user's prefs.
+  scoped_ptr<ui::Event> rewritten_event;
+  ASSERT_EQ(ui::EVENT_REWRITE_REWRITTEN,
+            rewriter.RewriteEvent(events[0], &rewritten_event));
+  EXPECT_EQ(ui::VKEY_CONTROL,
+            static_cast<ui::KeyEvent*>(rewritten_event.get())->key_code());
+
+  const size_t kIterations = 20000;
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (size_t i = 0; i < kIterations; ++i) {
+    for (size_t j = 0; j < arraysize(events); ++j) {
+      rewritten_event.reset();
+      rewriter.RewriteEvent(events[j], &rewritten_event);
+    }
+  }
+  const base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  perf_test::PrintResult(
+      "event_rewriter", "", "rewrite_key_event",
+      kIterations * arraysize(events) / std::max(elapsed.InSecondsF(), 1e-6),
+      "events/s", true);
+}
+
+}  // namespace chromeos
@@ -708,6 +708,53 @@ TEST_F(EventRewriterTest, TestRewriteModifiersRemapToControl) {
   }
 }
 
+TEST_F(EventRewriterTest, TestRewriteModifiersPrefServiceChanged) {
+  // Remap Search to Control in one set of prefs, and leave it alone in
+  // another, as for two signed-in users.
+  TestingPrefServiceSyncable remapped_prefs;
+  chromeos::Preferences::RegisterProfilePrefs(remapped_prefs.registry());
+  IntegerPrefMember search;
+  search.Init(prefs::kLanguageRemapSearchKeyTo, &remapped_prefs);
+  search.SetValue(chromeos::input_method::kControlKey);
+  TestingPrefServiceSyncable default_prefs;
+  chromeos::Preferences::RegisterProfilePrefs(default_prefs.registry());
+
+  EventRewriter rewriter;
+  rewriter.set_pref_service_for_testing(&remapped_prefs);
+  EXPECT_EQ(GetExpectedResultAsString(
+                ui::VKEY_CONTROL, ui::EF_CONTROL_DOWN, ui::ET_KEY_PRESSED),
+            GetRewrittenEventAsString(&rewriter,
+                                      ui::VKEY_LWIN,
+                                      ui::EF_COMMAND_DOWN,
+                                      ui::ET_KEY_PRESSED));
+
+  // Switching prefs must not use the remappings compiled from the old ones.
+  rewriter.set_pref_service_for_testing(&default_prefs);
+  EXPECT_EQ(GetExpectedResultAsString(
+                ui::VKEY_LWIN, ui::EF_COMMAND_DOWN, ui::ET_KEY_PRESSED),
+            GetRewrittenEventAsString(&rewriter,
+                                      ui::VKEY_LWIN,
+                                      ui::EF_COMMAND_DOWN,
+                                      ui::ET_KEY_PRESSED));
+
+  // Changes to prefs that are no longer in use have no effect, but changes
+  // to the ones in use do.
+  search.SetValue(chromeos::input_method::kAltKey);
+  EXPECT_EQ(GetExpectedResultAsString(
+                ui::VKEY_LWIN, ui::EF_COMMAND_DOWN, ui::ET_KEY_PRESSED),
+            GetRewrittenEventAsString(&rewriter,
+                                      ui::VKEY_LWIN,
+                                      ui::EF_COMMAND_DOWN,
+                                      ui::ET_KEY_PRESSED));
+  rewriter.set_pref_service_for_testing(&remapped_prefs);
+  EXPECT_EQ(GetExpectedResultAsString(
+                ui::VKEY_MENU, ui::EF_ALT_DOWN, ui::ET_KEY_PRESSED),
+            GetRewrittenEventAsString(&rewriter,
+                                      ui::VKEY_LWIN,
+                                      ui::EF_COMMAND_DOWN,
+                                      ui::ET_KEY_PRESSED));
+}
+
 TEST_F(EventRewriterTest, TestRewriteModifiersRemapToEscape) {
   // Remap Search to ESC.
   TestingPrefServiceSyncable prefs;
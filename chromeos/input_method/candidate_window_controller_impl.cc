@@ -4,6 +4,7 @@
 
 #include "chrome/browser/chromeos/input_method/candidate_window_controller_impl.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -13,6 +14,7 @@
 #include "ash/wm/window_util.h"
 #include "base/logging.h"
 #include "chrome/browser/chromeos/input_method/mode_indicator_controller.h"
+#include "ui/base/ime/candidate_window.h"
 #include "ui/gfx/screen.h"
 #include "ui/views/widget/widget.h"
 
@@ -59,7 +61,27 @@ void CandidateWindowControllerImpl::InitCandidateWindowView() {
                     CandidateWindowOpened());
 }
 
+// static
+void CandidateWindowControllerImpl::GetCurrentPage(
+    const ui::CandidateWindow& candidate_window,
+    ui::CandidateWindow* page) {
+  page->SetProperty(candidate_window.GetProperty());
+  const std::vector<ui::CandidateWindow::Entry>& candidates =
+      candidate_window.candidates();
+  const size_t page_size = candidate_window.page_size();
+  size_t begin = 0;
+  size_t end = candidates.size();
+  if (page_size) {
+    begin = std::min<size_t>(
+        candidate_window.cursor_position() / page_size * page_size, end);
+    end = std::min(begin + page_size, end);
+  }
+  page->mutable_candidates()->assign(candidates.begin() + begin,
+                                     candidates.begin() + end);
+}
+
 void CandidateWindowControllerImpl::Hide() {
+  shown_page_.reset();
   if (candidate_window_view_)
     candidate_window_view_->GetWidget()->Close();
   if (infolist_window_)
@@ -103,6 +125,7 @@ void CandidateWindowControllerImpl::UpdateLookupTable(
     bool visible) {
   // If it's not visible, hide the lookup table and return.
   if (!visible) {
+    shown_page_.reset();
     if (candidate_window_view_)
       candidate_window_view_->HideLookupTable();
     if (infolist_window_)
@@ -112,6 +135,14 @@ void CandidateWindowControllerImpl::UpdateLookupTable(
     return;
   }
 
+  // The view only shows the page containing the cursor, so if that page
+  // hasn't changed there is nothing to relayout.
+  scoped_ptr<ui::CandidateWindow> page(new ui::CandidateWindow);
+  GetCurrentPage(candidate_window, page.get());
+  if (candidate_window_view_ && shown_page_ && shown_page_->IsEqual(*page))
+    return;
+  shown_page_ = page.Pass();
+
   if (!candidate_window_view_)
     InitCandidateWindowView();
   candidate_window_view_->UpdateCandidates(candidate_window);
@@ -179,6 +210,7 @@ void CandidateWindowControllerImpl::OnWidgetClosing(views::Widget* widget) {
     widget->RemoveObserver(this);
     candidate_window_view_->RemoveObserver(this);
     candidate_window_view_ = NULL;
+    shown_page_.reset();
     FOR_EACH_OBSERVER(CandidateWindowController::Observer, observers_,
                       CandidateWindowClosed());
   }
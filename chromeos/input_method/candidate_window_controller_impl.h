@@ -59,6 +59,8 @@ class CandidateWindowControllerImpl
       bool* has_highlighted);
 
  private:
+  friend class CandidateWindowControllerImplTest;
+
   // ash::ime::CandidateWindowView::Observer implementation.
   virtual void OnCandidateCommitted(int index) OVERRIDE;
 
@@ -77,12 +79,22 @@ class CandidateWindowControllerImpl
 
   void InitCandidateWindowView();
 
+  // Copies the page of |candidate_window| that contains the cursor, along
+  // with its properties, to |page|.
+  static void GetCurrentPage(const ui::CandidateWindow& candidate_window,
+                             ui::CandidateWindow* page);
+
   // The candidate window view.
   ash::ime::CandidateWindowView* candidate_window_view_;
 
   // This is the outer frame of the infolist window view. Owned by the widget.
   ash::ime::InfolistWindow* infolist_window_;
 
+  // The page of the lookup table that is currently shown, or NULL if the
+  // lookup table is hidden. Updates that leave it unchanged, such as an IME
+  // appending candidates beyond it, don't need to relayout the view.
+  scoped_ptr<ui::CandidateWindow> shown_page_;
+
   gfx::Rect cursor_bounds_;
   gfx::Rect composition_head_;
 
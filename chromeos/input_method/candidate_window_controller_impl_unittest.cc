@@ -0,0 +1,131 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/chromeos/input_method/candidate_window_controller_impl.h"
+
+#include "ash/test/ash_test_base.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
+#include "chrome/browser/chromeos/input_method/input_method_configuration.h"
+#include "chrome/browser/chromeos/input_method/mock_input_method_manager.h"
+#include "ui/base/ime/candidate_window.h"
+#include "ui/base/ime/chromeos/ime_bridge.h"
+
+namespace chromeos {
+namespace input_method {
+
+namespace {
+
+// Appends candidates "<begin>" to "<end - 1>" to |candidate_window|.
+void AppendCandidates(int begin, int end,
+                      ui::CandidateWindow* candidate_window) {
+  for (int i = begin; i < end; ++i) {
+    ui::CandidateWindow::Entry entry;
+    entry.value = base::UTF8ToUTF16(base::IntToString(i));
+    candidate_window->mutable_candidates()->push_back(entry);
+  }
+}
+
+}  // namespace
+
+class CandidateWindowControllerImplTest : public ash::test::AshTestBase {
+ public:
+  CandidateWindowControllerImplTest() {}
+  virtual ~CandidateWindowControllerImplTest() {}
+
+  virtual void SetUp() OVERRIDE {
+    ash::test::AshTestBase::SetUp();
+    IMEBridge::Initialize();
+    InitializeForTesting(new MockInputMethodManager);
+    controller_.reset(new CandidateWindowControllerImpl);
+
+    candidate_window_.set_page_size(3);
+    AppendCandidates(0, 6, &candidate_window_);
+  }
+
+  virtual void TearDown() OVERRIDE {
+    controller_.reset();
+    Shutdown();
+    IMEBridge::Shutdown();
+    ash::test::AshTestBase::TearDown();
+  }
+
+ protected:
+  void UpdateLookupTable(bool visible) {
+    controller_->UpdateLookupTable(candidate_window_, visible);
+  }
+
+  // The page last pushed to the view. A new page is only allocated when the
+  // view is updated.
+  const ui::CandidateWindow* shown_page() const {
+    return controller_->shown_page_.get();
+  }
+
+  scoped_ptr<CandidateWindowControllerImpl> controller_;
+  ui::CandidateWindow candidate_window_;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(CandidateWindowControllerImplTest);
+};
+
+TEST_F(CandidateWindowControllerImplTest, UnchangedPageSkipsUpdate) {
+  UpdateLookupTable(true);
+  const ui::CandidateWindow* page = shown_page();
+  ASSERT_TRUE(page);
+  ASSERT_EQ(3u, page->candidates().size());
+
+  // Resending the same table doesn't update the view.
+  UpdateLookupTable(true);
+  EXPECT_EQ(page, shown_page());
+
+  // Neither does appending candidates past the shown page.
+  AppendCandidates(6, 9, &candidate_window_);
+  UpdateLookupTable(true);
+  EXPECT_EQ(page, shown_page());
+
+  // Moving the cursor within the page does.
+  candidate_window_.set_cursor_position(1);
+  UpdateLookupTable(true);
+  EXPECT_NE(page, shown_page());
+}
+
+TEST_F(CandidateWindowControllerImplTest, PageChangeUpdates) {
+  UpdateLookupTable(true);
+  const ui::CandidateWindow* page = shown_page();
+  ASSERT_TRUE(page);
+
+  candidate_window_.set_cursor_position(4);
+  UpdateLookupTable(true);
+  ASSERT_NE(page, shown_page());
+  ASSERT_EQ(3u, shown_page()->candidates().size());
+  EXPECT_EQ(base::ASCIIToUTF16("3"), shown_page()->candidates()[0].value);
+
+  // Changing a candidate on the shown page updates the view too.
+  page = shown_page();
+  (*candidate_window_.mutable_candidates())[5].value = base::ASCIIToUTF16("x");
+  UpdateLookupTable(true);
+  ASSERT_NE(page, shown_page());
+  EXPECT_EQ(base::ASCIIToUTF16("x"), shown_page()->candidates()[2].value);
+}
+
+TEST_F(CandidateWindowControllerImplTest, HideAndReshow) {
+  UpdateLookupTable(true);
+  ASSERT_TRUE(shown_page());
+
+  UpdateLookupTable(false);
+  EXPECT_FALSE(shown_page());
+
+  // Showing the same table again after hiding it must update the view.
+  UpdateLookupTable(true);
+  ASSERT_TRUE(shown_page());
+  EXPECT_EQ(3u, shown_page()->candidates().size());
+
+  controller_->Hide();
+  EXPECT_FALSE(shown_page());
+  UpdateLookupTable(true);
+  EXPECT_TRUE(shown_page());
+}
+
+}  // namespace input_method
+}  // namespace chromeos
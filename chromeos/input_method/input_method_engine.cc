@@ -46,6 +46,14 @@ const char* kCandidateNotFound = "Candidate not found";
 
 namespace {
 
+// Returns true if |a| and |b| produce the same candidate window entry.
+bool IsSameCandidate(const InputMethodEngineInterface::Candidate& a,
+                     const InputMethodEngineInterface::Candidate& b) {
+  return a.id == b.id && a.value == b.value && a.label == b.label &&
+         a.annotation == b.annotation && a.usage.title == b.usage.title &&
+         a.usage.body == b.usage.body;
+}
+
 // Notifies InputContextHandler that the composition is changed.
 void UpdateComposition(const CompositionText& composition_text,
                        uint32 cursor_pos,
@@ -353,24 +361,35 @@ bool InputMethodEngine::SetCandidates(
   }
 
   // TODO: Nested candidates
-  candidate_ids_.clear();
-  candidate_indexes_.clear();
-  candidate_window_->mutable_candidates()->clear();
-  for (std::vector<Candidate>::const_iterator ix = candidates.begin();
-       ix != candidates.end(); ++ix) {
-    ui::CandidateWindow::Entry entry;
-    entry.value = base::UTF8ToUTF16(ix->value);
-    entry.label = base::UTF8ToUTF16(ix->label);
-    entry.annotation = base::UTF8ToUTF16(ix->annotation);
-    entry.description_title = base::UTF8ToUTF16(ix->usage.title);
-    entry.description_body = base::UTF8ToUTF16(ix->usage.body);
-
+  // IMEs often resend the same list, or only append to it, while the user
+  // types. Only the entries of candidates that differ from the last call are
+  // converted; the full table is still sent to the candidate window handler.
+  std::vector<ui::CandidateWindow::Entry>* entries =
+      candidate_window_->mutable_candidates();
+  bool changed = candidates.size() != candidates_.size();
+  candidates_.resize(candidates.size());
+  entries->resize(candidates.size());
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    const Candidate& candidate = candidates[i];
+    if (IsSameCandidate(candidates_[i], candidate))
+      continue;
+    changed = true;
+    candidates_[i] = candidate;
+
+    ui::CandidateWindow::Entry& entry = (*entries)[i];
+    entry.value = base::UTF8ToUTF16(candidate.value);
+    entry.label = base::UTF8ToUTF16(candidate.label);
+    entry.annotation = base::UTF8ToUTF16(candidate.annotation);
+    entry.description_title = base::UTF8ToUTF16(candidate.usage.title);
+    entry.description_body = base::UTF8ToUTF16(candidate.usage.body);
+  }
+  if (changed) {
     // Store a mapping from the user defined ID to the candidate index.
-    candidate_indexes_[ix->id] = candidate_ids_.size();
-    candidate_ids_.push_back(ix->id);
-
-    candidate_window_->mutable_candidates()->push_back(entry);
+    candidate_indexes_.clear();
+    for (size_t i = 0; i < candidates_.size(); ++i)
+      candidate_indexes_[candidates_[i].id] = i;
   }
+
   if (active_) {
     IMECandidateWindowHandlerInterface* cw_handler =
         IMEBridge::Get()->GetCandidateWindowHandler();
@@ -645,13 +664,13 @@ void InputMethodEngine::ProcessKeyEvent(
 }
 
 void InputMethodEngine::CandidateClicked(uint32 index) {
-  if (index > candidate_ids_.size()) {
+  if (index >= candidates_.size()) {
     return;
   }
 
   // Only left button click is supported at this moment.
   observer_->OnCandidateClicked(
-      engine_id_, candidate_ids_.at(index), MOUSE_BUTTON_LEFT);
+      engine_id_, candidates_[index].id, MOUSE_BUTTON_LEFT);
 }
 
 void InputMethodEngine::SetSurroundingText(const std::string& text,
@@ -148,8 +148,10 @@ class InputMethodEngine : public InputMethodEngineInterface {
   // Indicates whether the candidate window is visible.
   bool window_visible_;
 
-  // Mapping of candidate index to candidate id.
-  std::vector<int> candidate_ids_;
+  // The candidates last passed to SetCandidates, in candidate window order.
+  // Used to map a candidate index to its id, and to only convert changed
+  // candidates into |candidate_window_| entries.
+  std::vector<Candidate> candidates_;
 
   // Mapping of candidate id to index.
   std::map<int, int> candidate_indexes_;
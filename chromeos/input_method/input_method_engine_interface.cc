@@ -22,7 +22,7 @@ InputMethodEngineInterface::MenuItem::MenuItem() {
 InputMethodEngineInterface::MenuItem::~MenuItem() {
 }
 
-InputMethodEngineInterface::Candidate::Candidate() {
+InputMethodEngineInterface::Candidate::Candidate() : id(0) {
 }
 
 InputMethodEngineInterface::Candidate::~Candidate() {
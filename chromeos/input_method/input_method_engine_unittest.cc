@@ -6,6 +6,7 @@
 #include "base/metrics/histogram.h"
 #include "base/metrics/histogram_samples.h"
 #include "base/metrics/statistics_recorder.h"
+#include "base/strings/utf_string_conversions.h"
 #include "chrome/browser/chromeos/input_method/input_method_configuration.h"
 #include "chrome/browser/chromeos/input_method/input_method_engine.h"
 #include "chrome/browser/chromeos/input_method/input_method_engine_interface.h"
@@ -13,6 +14,8 @@
 #include "chromeos/ime/extension_ime_util.h"
 #include "chromeos/ime/mock_component_extension_ime_manager_delegate.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "ui/base/ime/candidate_window.h"
+#include "ui/base/ime/chromeos/mock_ime_candidate_window_handler.h"
 #include "ui/base/ime/chromeos/mock_ime_input_context_handler.h"
 
 namespace chromeos {
@@ -297,5 +300,48 @@ TEST_F(InputMethodEngineTest, TestHistograms) {
   ExpectNewSample("InputMethod.CommitCharacter.test_engine_id", 7, 3, 1);
 }
 
+TEST_F(InputMethodEngineTest, TestSetCandidatesKeepsCandidateIds) {
+  MockIMECandidateWindowHandler candidate_window_handler;
+  IMEBridge::Get()->SetCandidateWindowHandler(&candidate_window_handler);
+  CreateEngine(true);
+  FocusIn(ui::TEXT_INPUT_TYPE_TEXT);
+  engine_->Enable();
+  std::string error;
+
+  std::vector<InputMethodEngineInterface::Candidate> candidates(2);
+  candidates[0].id = 10;
+  candidates[0].value = "a";
+  candidates[1].id = 20;
+  candidates[1].value = "b";
+  EXPECT_TRUE(engine_->SetCandidates(1, candidates, &error));
+
+  // Appending a candidate keeps the existing ones addressable by ID.
+  candidates.resize(3);
+  candidates[2].id = 30;
+  candidates[2].value = "c";
+  EXPECT_TRUE(engine_->SetCandidates(1, candidates, &error));
+  EXPECT_TRUE(engine_->SetCursorPosition(1, 30, &error));
+  EXPECT_EQ(2U, candidate_window_handler.last_update_lookup_table_arg()
+                    .lookup_table.cursor_position());
+  EXPECT_TRUE(engine_->SetCursorPosition(1, 20, &error));
+  EXPECT_EQ(1U, candidate_window_handler.last_update_lookup_table_arg()
+                    .lookup_table.cursor_position());
+
+  // Replacing a candidate drops its ID.
+  candidates[0].id = 40;
+  candidates[0].value = "d";
+  EXPECT_TRUE(engine_->SetCandidates(1, candidates, &error));
+  EXPECT_FALSE(engine_->SetCursorPosition(1, 10, &error));
+  EXPECT_TRUE(engine_->SetCursorPosition(1, 40, &error));
+  const ui::CandidateWindow& table =
+      candidate_window_handler.last_update_lookup_table_arg().lookup_table;
+  EXPECT_EQ(0U, table.cursor_position());
+  ASSERT_EQ(3U, table.candidates().size());
+  EXPECT_EQ(base::ASCIIToUTF16("d"), table.candidates()[0].value);
+  EXPECT_EQ(base::ASCIIToUTF16("c"), table.candidates()[2].value);
+
+  IMEBridge::Get()->SetCandidateWindowHandler(NULL);
+}
+
 }  // namespace input_method
 }  // namespace chromeos
@@ -105,6 +105,16 @@ void RecordDiscrepancyWithShill(
   }
 }
 
+void RecordTimeToDetection(const base::TimeDelta& duration) {
+  if (InSession()) {
+    UMA_HISTOGRAM_MEDIUM_TIMES(
+        NetworkPortalDetectorImpl::kSessionTimeToDetectionHistogram, duration);
+  } else {
+    UMA_HISTOGRAM_MEDIUM_TIMES(
+        NetworkPortalDetectorImpl::kOobeTimeToDetectionHistogram, duration);
+  }
+}
+
 void RecordPortalToOnlineTransition(const base::TimeDelta& duration) {
   if (InSession()) {
     UMA_HISTOGRAM_LONG_TIMES(
@@ -134,6 +144,8 @@ const char NetworkPortalDetectorImpl::kOobeShillOfflineHistogram[] =
     "CaptivePortal.OOBE.DiscrepancyWithShill_Offline";
 const char NetworkPortalDetectorImpl::kOobePortalToOnlineHistogram[] =
     "CaptivePortal.OOBE.PortalToOnlineTransition";
+const char NetworkPortalDetectorImpl::kOobeTimeToDetectionHistogram[] =
+    "CaptivePortal.OOBE.TimeToDetection";
 
 const char NetworkPortalDetectorImpl::kSessionDetectionResultHistogram[] =
     "CaptivePortal.Session.DetectionResult";
@@ -147,6 +159,8 @@ const char NetworkPortalDetectorImpl::kSessionShillOfflineHistogram[] =
     "CaptivePortal.Session.DiscrepancyWithShill_Offline";
 const char NetworkPortalDetectorImpl::kSessionPortalToOnlineHistogram[] =
     "CaptivePortal.Session.PortalToOnlineTransition";
+const char NetworkPortalDetectorImpl::kSessionTimeToDetectionHistogram[] =
+    "CaptivePortal.Session.TimeToDetection";
 
 NetworkPortalDetectorImpl::NetworkPortalDetectorImpl(
     const scoped_refptr<net::URLRequestContextGetter>& request_context)
@@ -265,6 +279,7 @@ void NetworkPortalDetectorImpl::DefaultNetworkChanged(
   if (!default_network) {
     default_network_name_.clear();
     default_network_id_.clear();
+    network_change_time_ = base::TimeTicks();
 
     StopDetection();
 
@@ -280,12 +295,28 @@ void NetworkPortalDetectorImpl::DefaultNetworkChanged(
   bool network_changed = (default_service_path_ != default_network->path());
   default_service_path_ = default_network->path();
 
+  // Shill often walks a network through several connected states (e.g. from
+  // "ready" to "portal") right after connecting. A probe that is already
+  // running for the network is still valid then, so keep it instead of
+  // cancelling it and starting a redundant one. A merely scheduled probe may
+  // be backed off, so it is rescheduled below.
+  bool was_connected =
+      NetworkState::StateIsConnected(default_connection_state_);
   bool connection_state_changed =
       (default_connection_state_ != default_network->connection_state());
   default_connection_state_ = default_network->connection_state();
+  if (!network_changed && connection_state_changed && was_connected &&
+      NetworkState::StateIsConnected(default_connection_state_) &&
+      is_checking_for_portal()) {
+    return;
+  }
 
-  if (network_changed || connection_state_changed)
+  if (network_changed || connection_state_changed) {
     StopDetection();
+    strategy_->Reset();
+    network_change_time_ = GetCurrentTimeTicks();
+    detection_start_time_ = network_change_time_;
+  }
 
   if (CanPerformAttempt() &&
       NetworkState::StateIsConnected(default_connection_state_)) {
@@ -320,6 +351,7 @@ base::TimeTicks NetworkPortalDetectorImpl::GetCurrentTimeTicks() {
 void NetworkPortalDetectorImpl::StartDetection() {
   attempt_count_ = 0;
   DCHECK(CanPerformAttempt());
+  strategy_->Reset();
   detection_start_time_ = GetCurrentTimeTicks();
   ScheduleAttempt(base::TimeDelta());
 }
@@ -451,7 +483,7 @@ void NetworkPortalDetectorImpl::OnAttemptCompleted(
       break;
   }
 
-  OnDetectionCompleted(network, state);
+  strategy_->OnDetectionCompleted(OnDetectionCompleted(network, state));
   if (CanPerformAttempt() && strategy_->CanPerformAttemptAfterDetection())
     ScheduleAttempt(base::TimeDelta());
 }
@@ -472,18 +504,25 @@ void NetworkPortalDetectorImpl::Observe(
   }
 }
 
-void NetworkPortalDetectorImpl::OnDetectionCompleted(
+bool NetworkPortalDetectorImpl::OnDetectionCompleted(
     const NetworkState* network,
     const CaptivePortalState& state) {
   if (!network) {
     NotifyDetectionCompleted(network, state);
-    return;
+    return false;
+  }
+
+  if (!network_change_time_.is_null()) {
+    RecordTimeToDetection(state.time - network_change_time_);
+    network_change_time_ = base::TimeTicks();
   }
 
+  bool state_changed = false;
   CaptivePortalStateMap::const_iterator it =
       portal_state_map_.find(network->path());
   if (it == portal_state_map_.end() || it->second.status != state.status ||
       it->second.response_code != state.response_code) {
+    state_changed = true;
     VLOG(1) << "Updating Chrome Captive Portal state: "
             << "name=" << network->name() << ", "
             << "id=" << network->guid() << ", "
@@ -503,6 +542,7 @@ void NetworkPortalDetectorImpl::OnDetectionCompleted(
     portal_state_map_[network->path()] = state;
   }
   NotifyDetectionCompleted(network, state);
+  return state_changed;
 }
 
 void NetworkPortalDetectorImpl::NotifyDetectionCompleted(
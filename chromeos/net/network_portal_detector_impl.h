@@ -52,6 +52,7 @@ class NetworkPortalDetectorImpl
   static const char kOobeShillPortalHistogram[];
   static const char kOobeShillOfflineHistogram[];
   static const char kOobePortalToOnlineHistogram[];
+  static const char kOobeTimeToDetectionHistogram[];
 
   static const char kSessionDetectionResultHistogram[];
   static const char kSessionDetectionDurationHistogram[];
@@ -59,6 +60,7 @@ class NetworkPortalDetectorImpl
   static const char kSessionShillPortalHistogram[];
   static const char kSessionShillOfflineHistogram[];
   static const char kSessionPortalToOnlineHistogram[];
+  static const char kSessionTimeToDetectionHistogram[];
 
   explicit NetworkPortalDetectorImpl(
       const scoped_refptr<net::URLRequestContextGetter>& request_context);
@@ -130,7 +132,8 @@ class NetworkPortalDetectorImpl
                        const content::NotificationDetails& details) OVERRIDE;
 
   // Stores captive portal state for a |network| and notifies observers.
-  void OnDetectionCompleted(const NetworkState* network,
+  // Returns true if the stored state changed.
+  bool OnDetectionCompleted(const NetworkState* network,
                             const CaptivePortalState& results);
 
   // Notifies observers that portal detection is completed for a |network|.
@@ -214,6 +217,10 @@ class NetworkPortalDetectorImpl
   // Start time of portal detection.
   base::TimeTicks detection_start_time_;
 
+  // Time when the default network or its connection state last changed, or
+  // null if a detection has completed since then.
+  base::TimeTicks network_change_time_;
+
   // Start time of detection attempt.
   base::TimeTicks attempt_start_time_;
 
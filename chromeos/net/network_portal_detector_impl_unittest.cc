@@ -149,6 +149,10 @@ class NetworkPortalDetectorImplTest
     return network_portal_detector()->AttemptTimeoutIsCancelledForTesting();
   }
 
+  PortalDetectorStrategy* strategy() {
+    return network_portal_detector()->strategy_.get();
+  }
+
   base::TimeDelta get_next_attempt_timeout() {
     return network_portal_detector()->strategy_->GetNextAttemptTimeout();
   }
@@ -980,4 +984,88 @@ TEST_F(NetworkPortalDetectorImplTest, StartDetectionIfIdle) {
           ->Check());
 }
 
+TEST_F(NetworkPortalDetectorImplTest, SessionStrategyBacksOffUnchangedResults) {
+  network_portal_detector()->SetStrategy(
+      PortalDetectorStrategy::STRATEGY_ID_SESSION);
+  ASSERT_EQ(PortalDetectorStrategy::STRATEGY_ID_SESSION, strategy()->Id());
+  set_attempt_count(3);
+
+  // No attempt has been started, so the regular delay between attempts has
+  // already elapsed and only the backoff applies.
+  strategy()->OnDetectionCompleted(true);
+  ASSERT_EQ(base::TimeDelta(), strategy()->GetDelayTillNextAttempt());
+
+  // Each detection which doesn't change the result doubles the delay, up to
+  // five minutes.
+  const int kExpectedDelaysSec[] = {10, 20, 40, 80, 160, 300, 300};
+  for (size_t i = 0; i < arraysize(kExpectedDelaysSec); ++i) {
+    SCOPED_TRACE(i);
+    strategy()->OnDetectionCompleted(false);
+    ASSERT_EQ(base::TimeDelta::FromSeconds(kExpectedDelaysSec[i]),
+              strategy()->GetDelayTillNextAttempt());
+  }
+
+  // A changed result, or a network change, ends the backoff.
+  strategy()->OnDetectionCompleted(true);
+  ASSERT_EQ(base::TimeDelta(), strategy()->GetDelayTillNextAttempt());
+  strategy()->OnDetectionCompleted(false);
+  strategy()->Reset();
+  ASSERT_EQ(base::TimeDelta(), strategy()->GetDelayTillNextAttempt());
+}
+
+TEST_F(NetworkPortalDetectorImplTest, ConnectedStateChangeKeepsRunningProbe) {
+  ASSERT_TRUE(is_state_idle());
+
+  SetConnected(kStubWireless1);
+  ASSERT_TRUE(is_state_checking_for_portal());
+  fetcher()->set_response_code(200);
+
+  // Shill moves the network from online to portal state while the probe is
+  // running. The probe isn't restarted.
+  SetBehindPortal(kStubWireless1);
+  ASSERT_TRUE(is_state_checking_for_portal());
+  ASSERT_EQ(0, attempt_count());
+
+  CompleteURLFetch(net::OK, 200, NULL);
+  ASSERT_TRUE(is_state_idle());
+  CheckPortalState(
+      NetworkPortalDetector::CAPTIVE_PORTAL_STATUS_PORTAL, 200, kStubWireless1);
+
+  ASSERT_TRUE(
+      MakeResultHistogramChecker()
+          ->Expect(NetworkPortalDetector::CAPTIVE_PORTAL_STATUS_PORTAL, 1)
+          ->Check());
+}
+
+TEST_F(NetworkPortalDetectorImplTest, ConnectedStateChangeReschedulesProbe) {
+  ASSERT_TRUE(is_state_idle());
+  network_portal_detector()->SetStrategy(
+      PortalDetectorStrategy::STRATEGY_ID_SESSION);
+
+  SetConnected(kStubWireless1);
+  ASSERT_TRUE(is_state_checking_for_portal());
+  CompleteURLFetch(net::OK, 204, NULL);
+
+  // The session strategy schedules another probe after a delay.
+  ASSERT_TRUE(is_state_portal_detection_pending());
+  ASSERT_LT(base::TimeDelta(), next_attempt_delay());
+  CheckPortalState(
+      NetworkPortalDetector::CAPTIVE_PORTAL_STATUS_ONLINE, 204, kStubWireless1);
+
+  // Shill moves the network from online to portal state. The pending probe,
+  // which may be backed off, is replaced by an immediate one.
+  SetBehindPortal(kStubWireless1);
+  ASSERT_EQ(base::TimeDelta(), next_attempt_delay());
+  ASSERT_TRUE(is_state_checking_for_portal());
+  CompleteURLFetch(net::OK, 200, NULL);
+  CheckPortalState(
+      NetworkPortalDetector::CAPTIVE_PORTAL_STATUS_PORTAL, 200, kStubWireless1);
+
+  ASSERT_TRUE(
+      MakeResultHistogramChecker()
+          ->Expect(NetworkPortalDetector::CAPTIVE_PORTAL_STATUS_ONLINE, 1)
+          ->Expect(NetworkPortalDetector::CAPTIVE_PORTAL_STATUS_PORTAL, 1)
+          ->Check());
+}
+
 }  // namespace chromeos
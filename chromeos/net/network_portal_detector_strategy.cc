@@ -4,6 +4,8 @@
 
 #include "chrome/browser/chromeos/net/network_portal_detector_strategy.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "chromeos/network/network_handler.h"
 #include "chromeos/network/network_state.h"
@@ -17,8 +19,6 @@ const NetworkState* DefaultNetwork() {
   return NetworkHandler::Get()->network_state_handler()->DefaultNetwork();
 }
 
-// TODO (ygorshenin@): reuse net::BackoffEntry for strategies.
-
 class LoginScreenStrategy : public PortalDetectorStrategy {
  public:
   static const int kMaxAttempts = 3;
@@ -48,12 +48,46 @@ class LoginScreenStrategy : public PortalDetectorStrategy {
   DISALLOW_COPY_AND_ASSIGN(LoginScreenStrategy);
 };
 
+// Policy for spacing out probes on the error screen while they keep returning
+// the same result. The user is actively waiting for the network here, so the
+// backoff stays short.
+const net::BackoffEntry::Policy kErrorScreenBackoffPolicy = {
+  // Number of initial errors to ignore before applying exponential backoff.
+  0,
+  // Initial delay in ms.
+  3 * 1000,
+  // Factor by which the waiting time will be multiplied.
+  2,
+  // Fuzzing percentage.
+  0,
+  // Maximum amount of time to delay requests in ms.
+  30 * 1000,
+  // Never discard the entry.
+  -1,
+  // Don't use initial delay unless the last request was an error.
+  false,
+};
+
+// Same as above, for the session. Probes are spaced out up to every five
+// minutes while the portal state of the default network stays the same.
+const net::BackoffEntry::Policy kSessionBackoffPolicy = {
+  0,
+  10 * 1000,
+  2,
+  0,
+  5 * 60 * 1000,
+  -1,
+  false,
+};
+
 class ErrorScreenStrategy : public PortalDetectorStrategy {
  public:
   static const int kDelayBetweenAttemptsSec = 3;
   static const int kAttemptTimeoutSec = 15;
 
-  ErrorScreenStrategy() {}
+  ErrorScreenStrategy() {
+    SetUnchangedResultBackoffPolicy(&kErrorScreenBackoffPolicy);
+  }
   virtual ~ErrorScreenStrategy() {}
 
  protected:
@@ -62,7 +96,9 @@ class ErrorScreenStrategy : public PortalDetectorStrategy {
   virtual bool CanPerformAttemptImpl() OVERRIDE { return true; }
   virtual bool CanPerformAttemptAfterDetectionImpl() OVERRIDE { return true; }
   virtual base::TimeDelta GetDelayTillNextAttemptImpl() OVERRIDE {
-    return AdjustDelay(base::TimeDelta::FromSeconds(kDelayBetweenAttemptsSec));
+    return std::max(
+        AdjustDelay(base::TimeDelta::FromSeconds(kDelayBetweenAttemptsSec)),
+        GetUnchangedResultBackoffDelay());
   }
   virtual base::TimeDelta GetNextAttemptTimeoutImpl() OVERRIDE {
     return base::TimeDelta::FromSeconds(kAttemptTimeoutSec);
@@ -81,7 +117,7 @@ class SessionStrategy : public PortalDetectorStrategy {
   static const int kSlowDelayBetweenAttemptsSec = 10;
   static const int kSlowAttemptTimeoutSec = 5;
 
-  SessionStrategy() {}
+  SessionStrategy() { SetUnchangedResultBackoffPolicy(&kSessionBackoffPolicy); }
   virtual ~SessionStrategy() {}
 
  protected:
@@ -94,7 +130,8 @@ class SessionStrategy : public PortalDetectorStrategy {
       delay = kFastDelayBetweenAttemptsSec;
     else
       delay = kSlowDelayBetweenAttemptsSec;
-    return AdjustDelay(base::TimeDelta::FromSeconds(delay));
+    return std::max(AdjustDelay(base::TimeDelta::FromSeconds(delay)),
+                    GetUnchangedResultBackoffDelay());
   }
   virtual base::TimeDelta GetNextAttemptTimeoutImpl() OVERRIDE {
     int timeout;
@@ -111,6 +148,31 @@ class SessionStrategy : public PortalDetectorStrategy {
 
 }  // namespace
 
+// PortalDetectorStrategy::BackoffEntry ---------------------------------------
+
+// net::BackoffEntry which reads time from the strategy's delegate, so that
+// tests can control it.
+class PortalDetectorStrategy::BackoffEntry : public net::BackoffEntry {
+ public:
+  BackoffEntry(const net::BackoffEntry::Policy* policy,
+               PortalDetectorStrategy* strategy)
+      : net::BackoffEntry(policy), strategy_(strategy) {}
+  virtual ~BackoffEntry() {}
+
+ protected:
+  // net::BackoffEntry overrides:
+  virtual base::TimeTicks ImplGetTimeNow() const OVERRIDE {
+    if (!strategy_->delegate_)
+      return net::BackoffEntry::ImplGetTimeNow();
+    return strategy_->delegate_->GetCurrentTimeTicks();
+  }
+
+ private:
+  PortalDetectorStrategy* strategy_;
+
+  DISALLOW_COPY_AND_ASSIGN(BackoffEntry);
+};
+
 // PortalDetectorStrategy -----------------------------------------------------
 
 // static
@@ -168,6 +230,20 @@ base::TimeDelta PortalDetectorStrategy::GetNextAttemptTimeout() {
   return GetNextAttemptTimeoutImpl();
 }
 
+void PortalDetectorStrategy::Reset() {
+  if (unchanged_result_backoff_)
+    unchanged_result_backoff_->Reset();
+}
+
+void PortalDetectorStrategy::OnDetectionCompleted(bool result_changed) {
+  if (!unchanged_result_backoff_)
+    return;
+  if (result_changed)
+    unchanged_result_backoff_->Reset();
+  else
+    unchanged_result_backoff_->InformOfRequest(false);
+}
+
 bool PortalDetectorStrategy::CanPerformAttemptImpl() { return false; }
 
 bool PortalDetectorStrategy::CanPerformAttemptAfterDetectionImpl() {
@@ -182,6 +258,17 @@ base::TimeDelta PortalDetectorStrategy::GetNextAttemptTimeoutImpl() {
   return base::TimeDelta();
 }
 
+void PortalDetectorStrategy::SetUnchangedResultBackoffPolicy(
+    const net::BackoffEntry::Policy* policy) {
+  unchanged_result_backoff_.reset(new BackoffEntry(policy, this));
+}
+
+base::TimeDelta PortalDetectorStrategy::GetUnchangedResultBackoffDelay() {
+  if (!unchanged_result_backoff_)
+    return base::TimeDelta();
+  return unchanged_result_backoff_->GetTimeUntilRelease();
+}
+
 base::TimeDelta PortalDetectorStrategy::AdjustDelay(
     const base::TimeDelta& delay) {
   if (!delegate_->AttemptCount())
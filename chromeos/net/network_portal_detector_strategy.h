@@ -9,6 +9,7 @@
 #include "base/macros.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/time/time.h"
+#include "net/base/backoff_entry.h"
 
 namespace chromeos {
 
@@ -55,11 +56,30 @@ class PortalDetectorStrategy {
   // Returns timeout for the next detection attempt.
   base::TimeDelta GetNextAttemptTimeout();
 
+  // Forgets the outcomes of previous detections. Should be called when a new
+  // detection sequence starts, e.g. when the default network or its connection
+  // state changes.
+  void Reset();
+
+  // Should be called when a detection completes. |result_changed| is true if
+  // the detection changed the captive portal state of the network. Strategies
+  // which keep probing after detection space out probes that keep returning
+  // the same result.
+  void OnDetectionCompleted(bool result_changed);
+
   virtual StrategyId Id() const = 0;
 
  protected:
   PortalDetectorStrategy();
 
+  // Sets the policy used to back off repeated attempts after detections which
+  // didn't change the result. Must outlive the strategy.
+  void SetUnchangedResultBackoffPolicy(const net::BackoffEntry::Policy* policy);
+
+  // Returns the delay the backoff policy still requires before the next
+  // attempt, or zero if no policy is set.
+  base::TimeDelta GetUnchangedResultBackoffDelay();
+
   // Interface for subclasses:
   virtual bool CanPerformAttemptImpl();
   virtual bool CanPerformAttemptAfterDetectionImpl();
@@ -74,6 +94,7 @@ class PortalDetectorStrategy {
 
  private:
   friend class NetworkPortalDetectorImplTest;
+  class BackoffEntry;
   friend class NetworkPortalDetectorImplBrowserTest;
 
   static void set_delay_till_next_attempt_for_testing(
@@ -105,6 +126,8 @@ class PortalDetectorStrategy {
   // True when |next_attempt_timeout_for_testing_| is initialized.
   static bool next_attempt_timeout_for_testing_initialized_;
 
+  scoped_ptr<BackoffEntry> unchanged_result_backoff_;
+
   DISALLOW_COPY_AND_ASSIGN(PortalDetectorStrategy);
 };
 
@@ -2,13 +2,21 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <utility>
 #include <vector>
 
 #include "base/bind.h"
 #include "base/file_util.h"
 #include "base/logging.h"
+#include "base/memory/scoped_vector.h"
+#include "base/posix/eintr_wrapper.h"
 #include "base/strings/string_number_conversions.h"
-#include "base/strings/string_split.h"
+#include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "chrome/browser/chromeos/power/cpu_data_collector.h"
@@ -22,13 +30,17 @@ namespace {
 // limit.
 const int kSamplingDurationLimitMs = 500;
 
-// The CPU data is sampled every |kCpuDataSamplePeriodSec| seconds.
+// The CPU data is sampled every |kCpuDataSamplePeriodSec| seconds by default.
 const int kCpuDataSamplePeriodSec = 30;
 
 // The value in the file /sys/devices/system/cpu/cpu<n>/online which indicates
 // that CPU-n is online.
 const int kCpuOnlineStatus = 1;
 
+// Size of the buffer sysfs files are read into. sysfs files are never larger
+// than a page.
+const size_t kSysfsReadBufferSize = 4096;
+
 // The base of the path to the files and directories which contain CPU data in
 // the sysfs.
 const char kCpuDataPathBase[] = "/sys/devices/system/cpu";
@@ -72,351 +84,570 @@ size_t IndexInVector(const std::string& str,
   return vector->size() - 1;
 }
 
-// Returns true if the |i|-th CPU is online; false otherwise.
-bool CpuIsOnline(const int i) {
-  const std::string online_file_format = base::StringPrintf(
-      "%s%s", kCpuDataPathBase, kCpuOnlinePathSuffixFormat);
-  const std::string cpu_online_file = base::StringPrintf(
-      online_file_format.c_str(), i);
-  if (!base::PathExists(base::FilePath(cpu_online_file))) {
-    // If the 'online' status file is missing, then it means that the CPU is
-    // not hot-pluggable and hence is always online.
-    return true;
+// Returns the path of the sysfs file for |cpu| described by |suffix_format|,
+// under |path_base|.
+std::string GetCpuFilePath(const std::string& path_base,
+                           const char* suffix_format,
+                           int cpu) {
+  return path_base + base::StringPrintf(suffix_format, cpu);
+}
+
+// Same as above, for files describing idle state |state| of |cpu|.
+std::string GetCpuIdleStateFilePath(const std::string& path_base,
+                                    const char* suffix_format,
+                                    int cpu,
+                                    int state) {
+  return path_base + base::StringPrintf(suffix_format, cpu, state);
+}
+
+void CloseFd(int* fd) {
+  if (*fd >= 0) {
+    if (IGNORE_EINTR(close(*fd)) < 0)
+      DPLOG(ERROR) << "close";
+    *fd = -1;
   }
+}
 
-  int online;
-  std::string cpu_online_string;
-  if (base::ReadFileToString(base::FilePath(cpu_online_file),
-                             &cpu_online_string)) {
-    base::TrimWhitespace(cpu_online_string, base::TRIM_ALL, &cpu_online_string);
-    if (base::StringToInt(cpu_online_string, &online))
-      return online == kCpuOnlineStatus;
+// Returns |str| without leading and trailing ASCII whitespace.
+base::StringPiece TrimWhitespacePiece(const base::StringPiece& str) {
+  size_t begin = 0;
+  size_t end = str.size();
+  while (begin < end && IsAsciiWhitespace(str[begin]))
+    ++begin;
+  while (end > begin && IsAsciiWhitespace(str[end - 1]))
+    --end;
+  return str.substr(begin, end - begin);
+}
+
+// Reads the sysfs file open at |fd| into |buffer| and points |contents| at the
+// data read, trimmed of surrounding whitespace. sysfs regenerates the contents
+// of an attribute on every read from offset 0, so the same fd can be re-read
+// with pread() instead of being reopened for each sample.
+bool ReadSysfsFile(int fd, char* buffer, base::StringPiece* contents) {
+  ssize_t length = HANDLE_EINTR(pread(fd, buffer, kSysfsReadBufferSize, 0));
+  if (length < 0 || static_cast<size_t>(length) >= kSysfsReadBufferSize)
+    return false;
+  *contents = TrimWhitespacePiece(base::StringPiece(buffer, length));
+  return true;
+}
+
+// Reads the number of possible CPUs on the system from the sysfs directory
+// |path_base|. Returns 1 on errors, as a system will at least have one CPU.
+int ReadCpuCount(const std::string& path_base) {
+  const std::string possible_cpu_path = path_base + kPossibleCpuPathSuffix;
+  if (!base::PathExists(base::FilePath(possible_cpu_path))) {
+    LOG(ERROR) << "File listing possible CPUs missing. "
+               << "Defaulting CPU count to 1.";
+    return 1;
+  }
+
+  std::string possible_string;
+  if (!base::ReadFileToString(base::FilePath(possible_cpu_path),
+                              &possible_string)) {
+    LOG(ERROR) << "Error reading the file listing possible CPUs. "
+               << "Defaulting CPU count to 1.";
+    return 1;
   }
 
-  LOG(ERROR) << "Bad format or error reading " << cpu_online_file << ". "
-             << "Assuming offline.";
-  return false;
+  int max_cpu;
+  // The possible CPUs are listed in the format "0-N". Hence, N is present
+  // in the substring starting at offset 2.
+  base::TrimWhitespace(possible_string, base::TRIM_ALL, &possible_string);
+  if (possible_string.find("-") != std::string::npos &&
+      possible_string.length() > 2 &&
+      base::StringToInt(possible_string.substr(2), &max_cpu)) {
+    return max_cpu + 1;
+  }
+
+  LOG(ERROR) << "Unknown format in the file listing possible CPUs. "
+             << "Defaulting CPU count to 1.";
+  return 1;
 }
 
-// Samples the CPU idle state information from sysfs. |cpu_count| is the number
-// of possible CPUs on the system. Sample at index i in |idle_samples|
-// corresponds to the idle state information of the i-th CPU.
-void SampleCpuIdleData(
-    int cpu_count,
-    std::vector<std::string>* cpu_idle_state_names,
-    std::vector<CpuDataCollector::StateOccupancySample>* idle_samples) {
-  base::Time start_time = base::Time::Now();
-  for (int cpu = 0; cpu < cpu_count; ++cpu) {
-    CpuDataCollector::StateOccupancySample idle_sample;
-    idle_sample.time = base::Time::Now();
-    idle_sample.time_in_state.reserve(cpu_idle_state_names->size());
-
-    if (!CpuIsOnline(cpu)) {
-      idle_sample.cpu_online = false;
-    } else {
+// Returns the upper bound on the number of samples kept for each CPU. This is
+// the number of samples taken in |PowerDataCollector::kSampleTimeLimitSec| at
+// the default sample period.
+size_t GetMaxSamplesPerCpu() {
+  return PowerDataCollector::kSampleTimeLimitSec / kCpuDataSamplePeriodSec;
+}
+
+}  // namespace
+
+// Samples CPU idle and CPU freq data from the sysfs. Files are opened on first
+// use and kept open; a CPU's idle and freq files are closed when the CPU goes
+// offline, as hot-unplugging removes them, and reopened when it comes back.
+// Once all files are open and the sample vectors have grown to their final
+// size, taking a sample does not allocate.
+class CpuDataCollector::Sampler
+    : public base::RefCountedThreadSafe<CpuDataCollector::Sampler> {
+ public:
+  // |cpu_data_path_base| is the sysfs directory holding the CPU data.
+  explicit Sampler(const std::string& cpu_data_path_base)
+      : cpu_data_path_base_(cpu_data_path_base),
+        cpu_count_(-1),
+        idle_samples_valid_(false),
+        freq_samples_valid_(false),
+        freq_stats_missing_logged_(false) {
+  }
+
+  // Samples the CPU idle and freq data of all CPUs. This should run on the
+  // blocking pool as reading from the sysfs is a blocking task. Also discovers
+  // the number of CPUs on the first call.
+  void SampleOnBlockingPool() {
+    DCHECK(!content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
+
+    if (cpu_count_ < 0) {
+      cpu_count_ = ReadCpuCount(cpu_data_path_base_);
+      for (int cpu = 0; cpu < cpu_count_; ++cpu)
+        cpu_files_.push_back(new CpuFiles(cpu));
+      idle_samples_.resize(cpu_count_);
+      freq_samples_.resize(cpu_count_);
+    }
+
+    idle_samples_valid_ = SampleCpuIdleData();
+    freq_samples_valid_ = SampleCpuFreqData();
+  }
+
+  // The results of the last call to SampleOnBlockingPool. If a sample is not
+  // valid (for example, if sampling was interrupted due to system suspension),
+  // it should be dropped. Otherwise, element at index i in the sample vectors
+  // is the sample of CPU i.
+  bool idle_samples_valid() const { return idle_samples_valid_; }
+  const std::vector<StateOccupancySample>& idle_samples() const {
+    return idle_samples_;
+  }
+  const std::vector<std::string>& idle_state_names() const {
+    return idle_state_names_;
+  }
+  bool freq_samples_valid() const { return freq_samples_valid_; }
+  const std::vector<StateOccupancySample>& freq_samples() const {
+    return freq_samples_;
+  }
+  const std::vector<std::string>& freq_state_names() const {
+    return freq_state_names_;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<Sampler>;
+
+  // The sysfs files of a single CPU. An fd of -1 means the file is not open.
+  struct CpuFiles {
+    explicit CpuFiles(int cpu)
+        : cpu(cpu),
+          online_fd(-1),
+          has_online_file(true),
+          freq_time_in_state_fd(-1),
+          idle_states_open(false) {
+    }
+
+    ~CpuFiles() {
+      CloseFd(&online_fd);
+      CloseFd(&freq_time_in_state_fd);
+      CloseIdleStateFiles();
+    }
+
+    void CloseIdleStateFiles() {
+      for (size_t i = 0; i < idle_state_time_fds.size(); ++i)
+        CloseFd(&idle_state_time_fds[i]);
+      idle_state_time_fds.clear();
+      idle_state_name_indices.clear();
+      idle_states_open = false;
+    }
+
+    const int cpu;
+
+    int online_fd;
+
+    // False if the CPU has no 'online' file, which means it is not
+    // hot-pluggable and hence is always online.
+    bool has_online_file;
+
+    int freq_time_in_state_fd;
+
+    // The 'time' file of each idle state, and the index of the name of the
+    // state in |idle_state_names_|.
+    std::vector<int> idle_state_time_fds;
+    std::vector<size_t> idle_state_name_indices;
+    bool idle_states_open;
+
+   private:
+    DISALLOW_COPY_AND_ASSIGN(CpuFiles);
+  };
+
+  ~Sampler() {}
+
+  // Returns true if the CPU is online; false otherwise.
+  bool CpuIsOnline(CpuFiles* files) {
+    if (!files->has_online_file)
+      return true;
+
+    if (files->online_fd < 0) {
+      const std::string cpu_online_file = GetCpuFilePath(
+          cpu_data_path_base_, kCpuOnlinePathSuffixFormat, files->cpu);
+      files->online_fd = HANDLE_EINTR(open(cpu_online_file.c_str(), O_RDONLY));
+      if (files->online_fd < 0) {
+        if (errno == ENOENT) {
+          files->has_online_file = false;
+          return true;
+        }
+        LOG(ERROR) << "Error opening " << cpu_online_file << ". "
+                   << "Assuming offline.";
+        return false;
+      }
+    }
+
+    base::StringPiece online_string;
+    int online;
+    if (ReadSysfsFile(files->online_fd, buffer_, &online_string) &&
+        base::StringToInt(online_string, &online)) {
+      return online == kCpuOnlineStatus;
+    }
+
+    LOG(ERROR) << "Bad format or error reading the online status of CPU "
+               << files->cpu << ". Assuming offline.";
+    CloseFd(&files->online_fd);
+    return false;
+  }
+
+  // Opens the 'time' file of each idle state of the CPU, and records the names
+  // of the states. Returns false on errors.
+  bool OpenIdleStateFiles(CpuFiles* files) {
+    DCHECK(!files->idle_states_open);
+    for (int state = 0; ; ++state) {
+      const std::string idle_state_dir = GetCpuIdleStateFilePath(
+          cpu_data_path_base_, kCpuIdleStateDirPathSuffixFormat, files->cpu,
+          state);
+      // This insures us from the unlikely case wherein the 'cpuidle_stats'
+      // kernel module is not loaded. This could happen on a VM.
+      if (!base::DirectoryExists(base::FilePath(idle_state_dir)))
+        break;
+
+      const std::string name_file_path = GetCpuIdleStateFilePath(
+          cpu_data_path_base_, kCpuIdleStateNamePathSuffixFormat, files->cpu,
+          state);
+      const std::string time_file_path = GetCpuIdleStateFilePath(
+          cpu_data_path_base_, kCpuIdleStateTimePathSuffixFormat, files->cpu,
+          state);
+
+      std::string state_name;
+      int time_fd = HANDLE_EINTR(open(time_file_path.c_str(), O_RDONLY));
+      if (time_fd < 0 ||
+          !base::ReadFileToString(base::FilePath(name_file_path),
+                                  &state_name)) {
+        LOG(ERROR) << "Error opening idle state files in " << idle_state_dir;
+        CloseFd(&time_fd);
+        files->CloseIdleStateFiles();
+        return false;
+      }
+
+      base::TrimWhitespace(state_name, base::TRIM_ALL, &state_name);
+      files->idle_state_time_fds.push_back(time_fd);
+      files->idle_state_name_indices.push_back(
+          IndexInVector(state_name, &idle_state_names_));
+    }
+    files->idle_states_open = true;
+    return true;
+  }
+
+  // Samples the CPU idle state information. Returns false if the samples
+  // should be dropped.
+  bool SampleCpuIdleData() {
+    base::Time start_time = base::Time::Now();
+    for (int cpu = 0; cpu < cpu_count_; ++cpu) {
+      CpuFiles* files = cpu_files_[cpu];
+      StateOccupancySample& idle_sample = idle_samples_[cpu];
+      idle_sample.time = base::Time::Now();
+      // clear() keeps the capacity of the vector, so no allocation happens
+      // once it has grown to the number of idle states.
+      idle_sample.time_in_state.clear();
+
+      if (!CpuIsOnline(files)) {
+        idle_sample.cpu_online = false;
+        files->CloseIdleStateFiles();
+        continue;
+      }
+
       idle_sample.cpu_online = true;
+      if (!files->idle_states_open && !OpenIdleStateFiles(files))
+        return false;
 
-      const std::string idle_state_dir_format = base::StringPrintf(
-          "%s%s", kCpuDataPathBase, kCpuIdleStateDirPathSuffixFormat);
-      for (int state_count = 0; ; ++state_count) {
-        std::string idle_state_dir = base::StringPrintf(
-            idle_state_dir_format.c_str(), cpu, state_count);
-        // This insures us from the unlikely case wherein the 'cpuidle_stats'
-        // kernel module is not loaded. This could happen on a VM.
-        if (!base::DirectoryExists(base::FilePath(idle_state_dir)))
-          break;
-
-        const std::string name_file_format = base::StringPrintf(
-            "%s%s", kCpuDataPathBase, kCpuIdleStateNamePathSuffixFormat);
-        const std::string name_file_path = base::StringPrintf(
-            name_file_format.c_str(), cpu, state_count);
-        DCHECK(base::PathExists(base::FilePath(name_file_path)));
-
-        const std::string time_file_format = base::StringPrintf(
-            "%s%s", kCpuDataPathBase, kCpuIdleStateTimePathSuffixFormat);
-        const std::string time_file_path = base::StringPrintf(
-            time_file_format.c_str(), cpu, state_count);
-        DCHECK(base::PathExists(base::FilePath(time_file_path)));
-
-        std::string state_name, occupancy_time_string;
+      for (size_t state = 0; state < files->idle_state_time_fds.size();
+           ++state) {
+        base::StringPiece occupancy_time_string;
         int64 occupancy_time_usec;
-        if (!base::ReadFileToString(base::FilePath(name_file_path),
-                                    &state_name) ||
-            !base::ReadFileToString(base::FilePath(time_file_path),
-                                    &occupancy_time_string)) {
+        if (!ReadSysfsFile(files->idle_state_time_fds[state], buffer_,
+                           &occupancy_time_string) ||
+            !base::StringToInt64(occupancy_time_string,
+                                 &occupancy_time_usec)) {
           // If an error occurs reading/parsing single state data, drop all the
           // samples as an incomplete sample can mislead consumers of this
-          // sample.
-          LOG(ERROR) << "Error reading idle state from "
-                     << idle_state_dir << ". Dropping sample.";
-          idle_samples->clear();
-          return;
+          // sample. Reopen the files on the next sample in case they went
+          // stale.
+          LOG(ERROR) << "Error reading idle state " << state << " of CPU "
+                     << cpu << ". Dropping sample.";
+          files->CloseIdleStateFiles();
+          return false;
         }
 
-        base::TrimWhitespace(state_name, base::TRIM_ALL, &state_name);
-        base::TrimWhitespace(
-            occupancy_time_string, base::TRIM_ALL, &occupancy_time_string);
-        if (base::StringToInt64(occupancy_time_string, &occupancy_time_usec)) {
-          // idle state occupancy time in sysfs is recorded in microseconds.
-          int64 time_in_state_ms = occupancy_time_usec / 1000;
-          size_t index = IndexInVector(state_name, cpu_idle_state_names);
-          if (index >= idle_sample.time_in_state.size())
-            idle_sample.time_in_state.resize(index + 1);
-          idle_sample.time_in_state[index] = time_in_state_ms;
-        } else {
-          LOG(ERROR) << "Bad format in " << time_file_path << ". "
-                     << "Dropping sample.";
-          idle_samples->clear();
-          return;
-        }
+        // idle state occupancy time in sysfs is recorded in microseconds.
+        size_t index = files->idle_state_name_indices[state];
+        if (index >= idle_sample.time_in_state.size())
+          idle_sample.time_in_state.resize(index + 1);
+        idle_sample.time_in_state[index] = occupancy_time_usec / 1000;
       }
     }
 
-    idle_samples->push_back(idle_sample);
+    // If there was an interruption in sampling (like system suspended),
+    // discard the samples!
+    int64 delay =
+        base::TimeDelta(base::Time::Now() - start_time).InMilliseconds();
+    if (delay > kSamplingDurationLimitMs) {
+      LOG(WARNING) << "Dropped an idle state sample due to excessive time "
+                   << "delay: " << delay << "milliseconds.";
+      return false;
+    }
+    return true;
   }
 
-  // If there was an interruption in sampling (like system suspended),
-  // discard the samples!
-  int64 delay =
-      base::TimeDelta(base::Time::Now() - start_time).InMilliseconds();
-  if (delay > kSamplingDurationLimitMs) {
-    idle_samples->clear();
-    LOG(WARNING) << "Dropped an idle state sample due to excessive time delay: "
-                 << delay << "milliseconds.";
+  // Returns the index of the name of the freq state |freq_in_khz| in
+  // |freq_state_names_|.
+  size_t FreqStateIndex(int freq_in_khz) {
+    for (size_t i = 0; i < freq_state_indices_.size(); ++i) {
+      if (freq_state_indices_[i].first == freq_in_khz)
+        return freq_state_indices_[i].second;
+    }
+
+    const std::string state_name = base::IntToString(freq_in_khz / 1000);
+    size_t index = IndexInVector(state_name, &freq_state_names_);
+    freq_state_indices_.push_back(std::make_pair(freq_in_khz, index));
+    return index;
   }
-}
 
-// Samples the CPU freq state information from sysfs. |cpu_count| is the number
-// of possible CPUs on the system. Sample at index i in |freq_samples|
-// corresponds to the freq state information of the i-th CPU.
-void SampleCpuFreqData(
-    int cpu_count,
-    std::vector<std::string>* cpu_freq_state_names,
-    std::vector<CpuDataCollector::StateOccupancySample>* freq_samples) {
-  base::Time start_time = base::Time::Now();
-  for (int cpu = 0; cpu < cpu_count; ++cpu) {
-    CpuDataCollector::StateOccupancySample freq_sample;
-    freq_sample.time_in_state.reserve(cpu_freq_state_names->size());
-
-    if (!CpuIsOnline(cpu)) {
-      freq_sample.time = base::Time::Now();
-      freq_sample.cpu_online = false;
-    } else {
-      freq_sample.cpu_online = true;
+  // Parses the contents of a 'time_in_state' file into |freq_sample|. Returns
+  // false on format errors.
+  bool ParseTimeInState(base::StringPiece time_in_state_string,
+                        StateOccupancySample* freq_sample) {
+    while (!time_in_state_string.empty()) {
+      size_t line_end = time_in_state_string.find('\n');
+      base::StringPiece line = time_in_state_string.substr(0, line_end);
+      time_in_state_string = line_end == base::StringPiece::npos ?
+          base::StringPiece() : time_in_state_string.substr(line_end + 1);
+
+      // Occupancy of each state is in the format "<state> <time>"
+      size_t separator = line.find(' ');
+      if (separator == base::StringPiece::npos)
+        return false;
+      int freq_in_khz;
+      int64 occupancy_time_centisecond;
+      if (!base::StringToInt(TrimWhitespacePiece(line.substr(0, separator)),
+                             &freq_in_khz) ||
+          !base::StringToInt64(TrimWhitespacePiece(line.substr(separator + 1)),
+                               &occupancy_time_centisecond)) {
+        return false;
+      }
+
+      size_t index = FreqStateIndex(freq_in_khz);
+      if (index >= freq_sample->time_in_state.size())
+        freq_sample->time_in_state.resize(index + 1);
+      // The occupancy time is in units of centiseconds.
+      freq_sample->time_in_state[index] = occupancy_time_centisecond * 10;
+    }
+    return true;
+  }
+
+  // Samples the CPU freq state information. Returns false if the samples
+  // should be dropped.
+  bool SampleCpuFreqData() {
+    base::Time start_time = base::Time::Now();
+    for (int cpu = 0; cpu < cpu_count_; ++cpu) {
+      CpuFiles* files = cpu_files_[cpu];
+      StateOccupancySample& freq_sample = freq_samples_[cpu];
+      freq_sample.time_in_state.clear();
+
+      if (!CpuIsOnline(files)) {
+        freq_sample.time = base::Time::Now();
+        freq_sample.cpu_online = false;
+        CloseFd(&files->freq_time_in_state_fd);
+        continue;
+      }
 
-      const std::string time_in_state_path_format = base::StringPrintf(
-          "%s%s", kCpuDataPathBase, kCpuFreqTimeInStatePathSuffixFormat);
-      const std::string time_in_state_path = base::StringPrintf(
-          time_in_state_path_format.c_str(), cpu);
-      if (!base::PathExists(base::FilePath(time_in_state_path))) {
-        // If the path to the 'time_in_state' for a single CPU is missing,
-        // then 'time_in_state' for all CPUs is missing. This could happen
-        // on a VM where the 'cpufreq_stats' kernel module is not loaded.
-        LOG(ERROR) << "CPU freq stats not available in sysfs.";
-        freq_samples->clear();
-        return;
+      freq_sample.cpu_online = true;
+      if (files->freq_time_in_state_fd < 0) {
+        const std::string time_in_state_path = GetCpuFilePath(
+            cpu_data_path_base_, kCpuFreqTimeInStatePathSuffixFormat, cpu);
+        files->freq_time_in_state_fd =
+            HANDLE_EINTR(open(time_in_state_path.c_str(), O_RDONLY));
+        if (files->freq_time_in_state_fd < 0) {
+          // If the 'time_in_state' for a single CPU is missing, then
+          // 'time_in_state' for all CPUs is missing. This could happen on a VM
+          // where the 'cpufreq_stats' kernel module is not loaded.
+          if (!freq_stats_missing_logged_) {
+            LOG(ERROR) << "CPU freq stats not available in sysfs.";
+            freq_stats_missing_logged_ = true;
+          }
+          return false;
+        }
       }
 
-      std::string time_in_state_string;
       // Note time as close to reading the file as possible. This is not
       // possible for idle state samples as the information for each state there
       // is recorded in different files.
-      base::Time now = base::Time::Now();
-      if (!base::ReadFileToString(base::FilePath(time_in_state_path),
-                                  &time_in_state_string)) {
-        LOG(ERROR) << "Error reading " << time_in_state_path << ". "
+      freq_sample.time = base::Time::Now();
+      base::StringPiece time_in_state_string;
+      if (!ReadSysfsFile(files->freq_time_in_state_fd, buffer_,
+                         &time_in_state_string)) {
+        LOG(ERROR) << "Error reading the freq stats of CPU " << cpu << ". "
                    << "Dropping sample.";
-        freq_samples->clear();
-        return;
+        CloseFd(&files->freq_time_in_state_fd);
+        return false;
       }
 
-      freq_sample.time = now;
-
-      std::vector<std::string> lines;
-      base::SplitString(time_in_state_string, '\n', &lines);
-      // The last line could end with '\n'. Ignore the last empty string in
-      // such cases.
-      size_t state_count = lines.size();
-      if (state_count > 0 && lines.back().empty())
-        state_count -= 1;
-      for (size_t state = 0; state < state_count; ++state) {
-        std::vector<std::string> pair;
-        int freq_in_khz;
-        int64 occupancy_time_centisecond;
-
-        // Occupancy of each state is in the format "<state> <time>"
-        base::SplitString(lines[state], ' ', &pair);
-        for (size_t s = 0; s < pair.size(); ++s)
-          base::TrimWhitespace(pair[s], base::TRIM_ALL, &pair[s]);
-        if (pair.size() == 2 &&
-            base::StringToInt(pair[0], &freq_in_khz) &&
-            base::StringToInt64(pair[1], &occupancy_time_centisecond)) {
-          const std::string state_name = base::IntToString(freq_in_khz / 1000);
-          size_t index = IndexInVector(state_name, cpu_freq_state_names);
-          if (index >= freq_sample.time_in_state.size())
-            freq_sample.time_in_state.resize(index + 1);
-          // The occupancy time is in units of centiseconds.
-          freq_sample.time_in_state[index] = occupancy_time_centisecond * 10;
-        } else {
-          LOG(ERROR) << "Bad format in " << time_in_state_path << ". "
-                     << "Dropping sample.";
-          freq_samples->clear();
-          return;
-        }
+      if (!ParseTimeInState(time_in_state_string, &freq_sample)) {
+        LOG(ERROR) << "Bad format in the freq stats of CPU " << cpu << ". "
+                   << "Dropping sample.";
+        return false;
       }
     }
 
-    freq_samples->push_back(freq_sample);
+    // If there was an interruption in sampling (like system suspended),
+    // discard the samples!
+    int64 delay =
+        base::TimeDelta(base::Time::Now() - start_time).InMilliseconds();
+    if (delay > kSamplingDurationLimitMs) {
+      LOG(WARNING) << "Dropped a freq state sample due to excessive time delay: "
+                   << delay << "milliseconds.";
+      return false;
+    }
+    return true;
   }
 
-  // If there was an interruption in sampling (like system suspended),
-  // discard the samples!
-  int64 delay =
-      base::TimeDelta(base::Time::Now() - start_time).InMilliseconds();
-  if (delay > kSamplingDurationLimitMs) {
-    freq_samples->clear();
-    LOG(WARNING) << "Dropped a freq state sample due to excessive time delay: "
-                 << delay << "milliseconds.";
-  }
-}
+  const std::string cpu_data_path_base_;
 
-// Samples CPU idle and CPU freq data from sysfs. This function should run on
-// the blocking pool as reading from sysfs is a blocking task. Elements at
-// index i in |idle_samples| and |freq_samples| correspond to the idle and
-// freq samples of CPU i. This also function reads the number of CPUs from
-// sysfs if *|cpu_count| < 0.
-void SampleCpuStateOnBlockingPool(
-    int* cpu_count,
-    std::vector<std::string>* cpu_idle_state_names,
-    std::vector<CpuDataCollector::StateOccupancySample>* idle_samples,
-    std::vector<std::string>* cpu_freq_state_names,
-    std::vector<CpuDataCollector::StateOccupancySample>* freq_samples) {
-  DCHECK(!content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
-
-  if (*cpu_count < 0) {
-    // Set |cpu_count_| to 1. If it is something else, it will get corrected
-    // later. A system will at least have one CPU. Hence, a value of 1 here
-    // will serve as a default value in case of errors.
-    *cpu_count = 1;
-    const std::string possible_cpu_path = base::StringPrintf(
-        "%s%s", kCpuDataPathBase, kPossibleCpuPathSuffix);
-    if (!base::PathExists(base::FilePath(possible_cpu_path))) {
-      LOG(ERROR) << "File listing possible CPUs missing. "
-                 << "Defaulting CPU count to 1.";
-    } else {
-      std::string possible_string;
-      if (base::ReadFileToString(base::FilePath(possible_cpu_path),
-                                 &possible_string)) {
-        int max_cpu;
-        // The possible CPUs are listed in the format "0-N". Hence, N is present
-        // in the substring starting at offset 2.
-        base::TrimWhitespace(possible_string, base::TRIM_ALL, &possible_string);
-        if (possible_string.find("-") != std::string::npos &&
-            possible_string.length() > 2 &&
-            base::StringToInt(possible_string.substr(2), &max_cpu)) {
-          *cpu_count = max_cpu + 1;
-        } else {
-          LOG(ERROR) << "Unknown format in the file listing possible CPUs. "
-                     << "Defaulting CPU count to 1.";
-        }
-      } else {
-        LOG(ERROR) << "Error reading the file listing possible CPUs. "
-                   << "Defaulting CPU count to 1.";
-      }
-    }
-  }
+  // The number of possible CPUs on the system, or -1 if not read yet.
+  int cpu_count_;
+  ScopedVector<CpuFiles> cpu_files_;
 
-  // Initialize the deques in the data vectors.
-  SampleCpuIdleData(*cpu_count, cpu_idle_state_names, idle_samples);
-  SampleCpuFreqData(*cpu_count, cpu_freq_state_names, freq_samples);
-}
+  std::vector<std::string> idle_state_names_;
+  std::vector<StateOccupancySample> idle_samples_;
+  bool idle_samples_valid_;
 
-}  // namespace
+  std::vector<std::string> freq_state_names_;
+  // Maps a frequency in kHz to the index of its name in |freq_state_names_|,
+  // so that the name is only formatted when a frequency is first seen.
+  std::vector<std::pair<int, size_t> > freq_state_indices_;
+  std::vector<StateOccupancySample> freq_samples_;
+  bool freq_samples_valid_;
+  bool freq_stats_missing_logged_;
+
+  char buffer_[kSysfsReadBufferSize];
+
+  DISALLOW_COPY_AND_ASSIGN(Sampler);
+};
 
-// Set |cpu_count_| to -1 and let SampleCpuStateOnBlockingPool discover the
-// correct number of CPUs.
-CpuDataCollector::CpuDataCollector() : cpu_count_(-1), weak_ptr_factory_(this) {
+CpuDataCollector::CpuDataCollector()
+    : samples_per_cpu_(GetMaxSamplesPerCpu()),
+      sampler_(new Sampler(kCpuDataPathBase)),
+      sample_pending_(false),
+      weak_ptr_factory_(this) {
 }
 
 CpuDataCollector::~CpuDataCollector() {
 }
 
 void CpuDataCollector::Start() {
+  StartWithSamplePeriod(base::TimeDelta::FromSeconds(kCpuDataSamplePeriodSec));
+}
+
+void CpuDataCollector::StartWithSamplePeriod(
+    const base::TimeDelta& sample_period) {
+  DCHECK_GT(sample_period.InMilliseconds(), 0);
+  // Buffers are sized when the first sample is committed.
+  DCHECK(cpu_idle_state_data_.empty() && cpu_freq_state_data_.empty());
+  samples_per_cpu_ = std::min(
+      GetMaxSamplesPerCpu(),
+      static_cast<size_t>(
+          base::TimeDelta::FromSeconds(
+              PowerDataCollector::kSampleTimeLimitSec) / sample_period));
+  samples_per_cpu_ = std::max(samples_per_cpu_, static_cast<size_t>(1));
   timer_.Start(FROM_HERE,
-               base::TimeDelta::FromSeconds(kCpuDataSamplePeriodSec),
+               sample_period,
                this,
                &CpuDataCollector::PostSampleCpuState);
 }
 
+void CpuDataCollector::SetCpuDataPathForTesting(const base::FilePath& path) {
+  DCHECK(!sample_pending_);
+  DCHECK(cpu_idle_state_data_.empty() && cpu_freq_state_data_.empty());
+  sampler_ = new Sampler(path.value());
+}
+
 void CpuDataCollector::PostSampleCpuState() {
-  int* cpu_count = new int(cpu_count_);
-  std::vector<std::string>* cpu_idle_state_names =
-      new std::vector<std::string>(cpu_idle_state_names_);
-  std::vector<StateOccupancySample>* idle_samples =
-      new std::vector<StateOccupancySample>;
-  std::vector<std::string>* cpu_freq_state_names =
-      new std::vector<std::string>(cpu_freq_state_names_);
-  std::vector<StateOccupancySample>* freq_samples =
-      new std::vector<StateOccupancySample>;
+  // At high sample rates, the blocking pool may not have finished the previous
+  // sample yet. Skip this one rather than queueing reads behind it.
+  if (sample_pending_)
+    return;
+  sample_pending_ = true;
 
   content::BrowserThread::PostBlockingPoolTaskAndReply(
       FROM_HERE,
-      base::Bind(&SampleCpuStateOnBlockingPool,
-                 base::Unretained(cpu_count),
-                 base::Unretained(cpu_idle_state_names),
-                 base::Unretained(idle_samples),
-                 base::Unretained(cpu_freq_state_names),
-                 base::Unretained(freq_samples)),
+      base::Bind(&Sampler::SampleOnBlockingPool, sampler_),
       base::Bind(&CpuDataCollector::SaveCpuStateSamplesOnUIThread,
-                 weak_ptr_factory_.GetWeakPtr(),
-                 base::Owned(cpu_count),
-                 base::Owned(cpu_idle_state_names),
-                 base::Owned(idle_samples),
-                 base::Owned(cpu_freq_state_names),
-                 base::Owned(freq_samples)));
+                 weak_ptr_factory_.GetWeakPtr()));
 }
 
-void CpuDataCollector::SaveCpuStateSamplesOnUIThread(
-    const int* cpu_count,
-    const std::vector<std::string>* cpu_idle_state_names,
-    const std::vector<CpuDataCollector::StateOccupancySample>* idle_samples,
-    const std::vector<std::string>* cpu_freq_state_names,
-    const std::vector<CpuDataCollector::StateOccupancySample>* freq_samples) {
+void CpuDataCollector::SaveCpuStateSamplesOnUIThread() {
   DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
-
-  cpu_count_ = *cpu_count;
-
-  // |idle_samples| or |freq_samples| could be empty sometimes (for example, if
-  // sampling was interrupted due to system suspension). Iff they are not empty,
-  // they will have one sample each for each of the CPUs.
-
-  if (!idle_samples->empty()) {
-    // When committing the first sample, resize the data vector to the number of
-    // CPUs on the system. This number should be the same as the number of
-    // samples in |idle_samples|.
+  DCHECK(sample_pending_);
+  sample_pending_ = false;
+
+  // The samples may be dropped sometimes (for example, if sampling was
+  // interrupted due to system suspension). When they are not, there is one
+  // sample for each of the CPUs.
+
+  const std::vector<StateOccupancySample>& idle_samples =
+      sampler_->idle_samples();
+  if (sampler_->idle_samples_valid()) {
+    // When committing the first sample, create a buffer for each CPU on the
+    // system. This number should be the same as the number of samples in
+    // |idle_samples|.
     if (cpu_idle_state_data_.empty()) {
-      cpu_idle_state_data_.resize(idle_samples->size());
+      cpu_idle_state_data_.resize(
+          idle_samples.size(),
+          StateOccupancySampleBuffer(
+              samples_per_cpu_,
+              base::TimeDelta::FromSeconds(
+                  PowerDataCollector::kSampleTimeLimitSec)));
     } else {
-      DCHECK_EQ(idle_samples->size(), cpu_idle_state_data_.size());
+      DCHECK_EQ(idle_samples.size(), cpu_idle_state_data_.size());
     }
     for (size_t i = 0; i < cpu_idle_state_data_.size(); ++i)
-      AddSample(&cpu_idle_state_data_[i], (*idle_samples)[i]);
+      cpu_idle_state_data_[i].Add(idle_samples[i]);
 
-    cpu_idle_state_names_ = *cpu_idle_state_names;
+    // State names are only ever appended to.
+    if (cpu_idle_state_names_.size() != sampler_->idle_state_names().size())
+      cpu_idle_state_names_ = sampler_->idle_state_names();
   }
 
-  if (!freq_samples->empty()) {
-    // As with idle samples, resize the data vector before committing the first
+  const std::vector<StateOccupancySample>& freq_samples =
+      sampler_->freq_samples();
+  if (sampler_->freq_samples_valid()) {
+    // As with idle samples, create the buffers before committing the first
     // sample.
     if (cpu_freq_state_data_.empty()) {
-      cpu_freq_state_data_.resize(freq_samples->size());
+      cpu_freq_state_data_.resize(
+          freq_samples.size(),
+          StateOccupancySampleBuffer(
+              samples_per_cpu_,
+              base::TimeDelta::FromSeconds(
+                  PowerDataCollector::kSampleTimeLimitSec)));
     } else {
-      DCHECK_EQ(freq_samples->size(), cpu_freq_state_data_.size());
+      DCHECK_EQ(freq_samples.size(), cpu_freq_state_data_.size());
     }
     for (size_t i = 0; i < cpu_freq_state_data_.size(); ++i)
-      AddSample(&cpu_freq_state_data_[i], (*freq_samples)[i]);
+      cpu_freq_state_data_[i].Add(freq_samples[i]);
 
-    cpu_freq_state_names_ = *cpu_freq_state_names;
+    if (cpu_freq_state_names_.size() != sampler_->freq_state_names().size())
+      cpu_freq_state_names_ = sampler_->freq_state_names();
   }
 }
 
@@ -427,4 +658,41 @@ CpuDataCollector::StateOccupancySample::StateOccupancySample()
 CpuDataCollector::StateOccupancySample::~StateOccupancySample() {
 }
 
+CpuDataCollector::StateOccupancySampleBuffer::StateOccupancySampleBuffer(
+    size_t capacity,
+    base::TimeDelta max_age)
+    : samples_(capacity),
+      max_age_(max_age),
+      begin_(0),
+      size_(0) {
+  DCHECK_GT(capacity, 0u);
+}
+
+CpuDataCollector::StateOccupancySampleBuffer::~StateOccupancySampleBuffer() {
+}
+
+const CpuDataCollector::StateOccupancySample&
+CpuDataCollector::StateOccupancySampleBuffer::operator[](size_t i) const {
+  DCHECK_LT(i, size_);
+  return samples_[(begin_ + i) % samples_.size()];
+}
+
+void CpuDataCollector::StateOccupancySampleBuffer::Add(
+    const StateOccupancySample& sample) {
+  while (!empty() && sample.time - (*this)[0].time > max_age_)
+    PopFront();
+  if (size_ == capacity())
+    PopFront();
+  // Assigning into the existing slot reuses the capacity of its
+  // |time_in_state| vector.
+  samples_[(begin_ + size_) % samples_.size()] = sample;
+  ++size_;
+}
+
+void CpuDataCollector::StateOccupancySampleBuffer::PopFront() {
+  DCHECK(!empty());
+  begin_ = (begin_ + 1) % samples_.size();
+  --size_;
+}
+
 }  // namespace chromeos
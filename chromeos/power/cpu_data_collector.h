@@ -5,12 +5,12 @@
 #ifndef CHROME_BROWSER_CHROMEOS_POWER_CPU_DATA_COLLECTOR_H_
 #define CHROME_BROWSER_CHROMEOS_POWER_CPU_DATA_COLLECTOR_H_
 
-#include <deque>
-#include <map>
 #include <string>
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "base/time/time.h"
 #include "base/timer/timer.h"
@@ -23,6 +23,10 @@ namespace chromeos {
 // other times, it is best for the consumer of this data to calculate percentage
 // occupancy information using suspend time data from
 // PowerDataCollector::system_resumed_data.
+//
+// The sysfs files are opened once and re-read in place on every sample, and
+// samples are kept in fixed-size ring buffers, so sampling at a high rate does
+// not allocate once the buffers have filled up.
 class CpuDataCollector {
  public:
   struct StateOccupancySample {
@@ -43,13 +47,41 @@ class CpuDataCollector {
     std::vector<int64> time_in_state;
   };
 
-  typedef std::deque<StateOccupancySample> StateOccupancySampleDeque;
+  // A fixed-capacity buffer of samples ordered from oldest to newest. Once
+  // full, adding a sample overwrites the oldest one in place, reusing the
+  // storage of its |time_in_state|.
+  class StateOccupancySampleBuffer {
+   public:
+    // Samples older than |max_age| relative to the newest sample are dropped.
+    StateOccupancySampleBuffer(size_t capacity, base::TimeDelta max_age);
+    ~StateOccupancySampleBuffer();
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return samples_.size(); }
+
+    // Returns the |i|-th oldest sample.
+    const StateOccupancySample& operator[](size_t i) const;
+
+    // Adds a copy of |sample| as the newest sample.
+    void Add(const StateOccupancySample& sample);
+
+   private:
+    void PopFront();
+
+    std::vector<StateOccupancySample> samples_;
+    base::TimeDelta max_age_;
+
+    // Index in |samples_| of the oldest sample.
+    size_t begin_;
+    size_t size_;
+  };
 
   const std::vector<std::string>& cpu_idle_state_names() const {
     return cpu_idle_state_names_;
   }
 
-  const std::vector<StateOccupancySampleDeque>& cpu_idle_state_data() const {
+  const std::vector<StateOccupancySampleBuffer>& cpu_idle_state_data() const {
     return cpu_idle_state_data_;
   }
 
@@ -57,7 +89,7 @@ class CpuDataCollector {
     return cpu_freq_state_names_;
   }
 
-  const std::vector<StateOccupancySampleDeque>& cpu_freq_state_data() const {
+  const std::vector<StateOccupancySampleBuffer>& cpu_freq_state_data() const {
     return cpu_freq_state_data_;
   }
 
@@ -68,41 +100,57 @@ class CpuDataCollector {
   // CPU state occupancy samples.
   void Start();
 
+  // Same as Start, but samples every |sample_period| instead of the default
+  // period. Shorter periods keep a proportionally shorter history, as the
+  // number of samples kept per CPU is bounded.
+  void StartWithSamplePeriod(const base::TimeDelta& sample_period);
+
+  // Reads the CPU data from |path| instead of the sysfs. Must be called before
+  // the first sample is taken.
+  void SetCpuDataPathForTesting(const base::FilePath& path);
+
  private:
-  // Posts callbacks to the blocking pool which collect CPU state occupancy
-  // samples from the sysfs.
+  friend class CpuDataCollectorTest;
+
+  // Reads CPU state occupancy samples from the sysfs on the blocking pool.
+  // Defined in the .cc file.
+  class Sampler;
+
+  // Posts a callback to the blocking pool which collects CPU state occupancy
+  // samples from the sysfs. Does nothing if the previous sample has not been
+  // committed yet.
   void PostSampleCpuState();
 
-  // This function commits the CPU count and samples read by
-  // SampleCpuStateOnBlockingPool to |cpu_idle_state_data_| and
-  // |cpu_freq_state_data_|. Since UI is the consumer of CPU idle and freq data,
-  // this function should run on the UI thread.
-  void SaveCpuStateSamplesOnUIThread(
-      const int* cpu_count,
-      const std::vector<std::string>* cpu_idle_state_names,
-      const std::vector<StateOccupancySample>* idle_samples,
-      const std::vector<std::string>* cpu_freq_state_names,
-      const std::vector<StateOccupancySample>* freq_samples);
+  // This function commits the samples read by |sampler_| to
+  // |cpu_idle_state_data_| and |cpu_freq_state_data_|. Since UI is the
+  // consumer of CPU idle and freq data, this function should run on the UI
+  // thread.
+  void SaveCpuStateSamplesOnUIThread();
 
   base::RepeatingTimer<CpuDataCollector> timer_;
 
+  // Number of samples kept for each CPU; derived from the sample period.
+  size_t samples_per_cpu_;
+
   // Names of the idle states.
   std::vector<std::string> cpu_idle_state_names_;
 
-  // The deque at index <i> in the vector corresponds to the idle state
+  // The buffer at index <i> in the vector corresponds to the idle state
   // occupancy data of CPU<i>.
-  std::vector<StateOccupancySampleDeque> cpu_idle_state_data_;
+  std::vector<StateOccupancySampleBuffer> cpu_idle_state_data_;
 
   // Names of the freq states.
   std::vector<std::string> cpu_freq_state_names_;
 
-  // The deque at index <i> in the vector corresponds to the frequency state
+  // The buffer at index <i> in the vector corresponds to the frequency state
   // occupancy data of CPU<i>.
-  std::vector<StateOccupancySampleDeque> cpu_freq_state_data_;
+  std::vector<StateOccupancySampleBuffer> cpu_freq_state_data_;
 
-  // The number of CPUs on the system. This value is read from the sysfs, and
-  // hence should be read/written to only from the blocking pool.
-  int cpu_count_;
+  // Owns the open sysfs files and the scratch samples. It is only touched by
+  // the blocking pool while |sample_pending_| is true, and by the UI thread
+  // otherwise.
+  scoped_refptr<Sampler> sampler_;
+  bool sample_pending_;
 
   base::WeakPtrFactory<CpuDataCollector> weak_ptr_factory_;
   DISALLOW_COPY_AND_ASSIGN(CpuDataCollector);
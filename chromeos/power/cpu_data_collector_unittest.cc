@@ -0,0 +1,199 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/chromeos/power/cpu_data_collector.h"
+
+#include <string>
+
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/sequenced_worker_pool.h"
+#include "chrome/browser/chromeos/power/power_data_collector.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/test/test_browser_thread_bundle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace chromeos {
+
+class CpuDataCollectorTest : public testing::Test {
+ public:
+  CpuDataCollectorTest() {}
+
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    // CPU 0 has no 'online' file, so it is always online; CPU 1 is
+    // hot-pluggable.
+    WriteFile("possible", "0-1\n");
+    WriteFile("cpu1/online", "1\n");
+    for (int cpu = 0; cpu < 2; ++cpu) {
+      WriteIdleState(cpu, 0, "C0", 3000);
+      WriteIdleState(cpu, 1, "C1", 5000);
+      WriteTimeInState(cpu, "100000 5\n200000 7\n");
+    }
+    collector_.SetCpuDataPathForTesting(temp_dir_.path());
+  }
+
+ protected:
+  void WriteFile(const std::string& relative_path,
+                 const std::string& contents) {
+    base::FilePath path = temp_dir_.path().Append(relative_path);
+    ASSERT_TRUE(base::CreateDirectory(path.DirName()));
+    ASSERT_EQ(static_cast<int>(contents.size()),
+              base::WriteFile(path, contents.data(), contents.size()));
+  }
+
+  void WriteIdleState(int cpu,
+                      int state,
+                      const std::string& name,
+                      int64 time_usec) {
+    const std::string dir = base::StringPrintf("cpu%d/cpuidle/state%d", cpu,
+                                               state);
+    WriteFile(dir + "/name", name + "\n");
+    WriteFile(dir + "/time", base::Int64ToString(time_usec) + "\n");
+  }
+
+  void WriteTimeInState(int cpu, const std::string& contents) {
+    WriteFile(base::StringPrintf("cpu%d/cpufreq/stats/time_in_state", cpu),
+              contents);
+  }
+
+  // Deletes the idle and freq files of |cpu|, as hot-unplugging does.
+  void DeleteCpuFiles(int cpu) {
+    ASSERT_TRUE(base::DeleteFile(
+        temp_dir_.path().Append(base::StringPrintf("cpu%d/cpuidle", cpu)),
+        true));
+    ASSERT_TRUE(base::DeleteFile(
+        temp_dir_.path().Append(base::StringPrintf("cpu%d/cpufreq", cpu)),
+        true));
+  }
+
+  // Takes one sample and waits for it to be committed.
+  void Sample() {
+    collector_.PostSampleCpuState();
+    content::BrowserThread::GetBlockingPool()->FlushForTesting();
+    base::RunLoop().RunUntilIdle();
+  }
+
+  const CpuDataCollector::StateOccupancySample& LastIdleSample(int cpu) {
+    const CpuDataCollector::StateOccupancySampleBuffer& samples =
+        collector_.cpu_idle_state_data()[cpu];
+    return samples[samples.size() - 1];
+  }
+
+  const CpuDataCollector::StateOccupancySample& LastFreqSample(int cpu) {
+    const CpuDataCollector::StateOccupancySampleBuffer& samples =
+        collector_.cpu_freq_state_data()[cpu];
+    return samples[samples.size() - 1];
+  }
+
+  void StopTimer() { collector_.timer_.Stop(); }
+
+  content::TestBrowserThreadBundle thread_bundle_;
+  base::ScopedTempDir temp_dir_;
+  CpuDataCollector collector_;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(CpuDataCollectorTest);
+};
+
+TEST_F(CpuDataCollectorTest, ParsesSysfsFiles) {
+  Sample();
+
+  ASSERT_EQ(2u, collector_.cpu_idle_state_data().size());
+  ASSERT_EQ(2u, collector_.cpu_idle_state_names().size());
+  EXPECT_EQ("C0", collector_.cpu_idle_state_names()[0]);
+  EXPECT_EQ("C1", collector_.cpu_idle_state_names()[1]);
+  ASSERT_EQ(2u, collector_.cpu_freq_state_names().size());
+  EXPECT_EQ("100", collector_.cpu_freq_state_names()[0]);
+  EXPECT_EQ("200", collector_.cpu_freq_state_names()[1]);
+
+  for (int cpu = 0; cpu < 2; ++cpu) {
+    const CpuDataCollector::StateOccupancySample& idle = LastIdleSample(cpu);
+    EXPECT_TRUE(idle.cpu_online);
+    ASSERT_EQ(2u, idle.time_in_state.size());
+    // Idle times are in microseconds, freq times in centiseconds.
+    EXPECT_EQ(3, idle.time_in_state[0]);
+    EXPECT_EQ(5, idle.time_in_state[1]);
+
+    const CpuDataCollector::StateOccupancySample& freq = LastFreqSample(cpu);
+    EXPECT_TRUE(freq.cpu_online);
+    ASSERT_EQ(2u, freq.time_in_state.size());
+    EXPECT_EQ(50, freq.time_in_state[0]);
+    EXPECT_EQ(70, freq.time_in_state[1]);
+  }
+}
+
+// Files stay open between samples and are re-read in place.
+TEST_F(CpuDataCollectorTest, RereadsOpenFiles) {
+  Sample();
+  WriteIdleState(0, 1, "C1", 9000);
+  WriteTimeInState(0, "100000 6\n200000 7\n300000 1\n");
+  Sample();
+
+  ASSERT_EQ(2u, collector_.cpu_idle_state_data()[0].size());
+  EXPECT_EQ(9, LastIdleSample(0).time_in_state[1]);
+  ASSERT_EQ(3u, collector_.cpu_freq_state_names().size());
+  EXPECT_EQ("300", collector_.cpu_freq_state_names()[2]);
+  ASSERT_EQ(3u, LastFreqSample(0).time_in_state.size());
+  EXPECT_EQ(60, LastFreqSample(0).time_in_state[0]);
+  EXPECT_EQ(10, LastFreqSample(0).time_in_state[2]);
+}
+
+// A CPU's files are closed while it is offline and reopened when it comes
+// back, picking up the files created by the kernel on hotplug.
+TEST_F(CpuDataCollectorTest, ReopensFilesAfterOffline) {
+  Sample();
+
+  WriteFile("cpu1/online", "0\n");
+  DeleteCpuFiles(1);
+  Sample();
+  EXPECT_FALSE(LastIdleSample(1).cpu_online);
+  EXPECT_TRUE(LastIdleSample(1).time_in_state.empty());
+  EXPECT_FALSE(LastFreqSample(1).cpu_online);
+
+  WriteFile("cpu1/online", "1\n");
+  WriteIdleState(1, 0, "C0", 1000);
+  WriteTimeInState(1, "100000 2\n");
+  Sample();
+  EXPECT_TRUE(LastIdleSample(1).cpu_online);
+  ASSERT_EQ(1u, LastIdleSample(1).time_in_state.size());
+  EXPECT_EQ(1, LastIdleSample(1).time_in_state[0]);
+  ASSERT_EQ(1u, LastFreqSample(1).time_in_state.size());
+  EXPECT_EQ(20, LastFreqSample(1).time_in_state[0]);
+}
+
+// Malformed data drops the whole sample, and a file that errors is reopened
+// on the next sample.
+TEST_F(CpuDataCollectorTest, DropsMalformedSamples) {
+  Sample();
+
+  WriteTimeInState(1, "100000\n");
+  WriteFile("cpu0/cpuidle/state0/time", "garbage\n");
+  Sample();
+  EXPECT_EQ(1u, collector_.cpu_freq_state_data()[0].size());
+  EXPECT_EQ(1u, collector_.cpu_idle_state_data()[0].size());
+
+  WriteTimeInState(1, "100000 8\n200000 7\n");
+  WriteIdleState(0, 0, "C0", 4000);
+  Sample();
+  EXPECT_EQ(2u, collector_.cpu_freq_state_data()[0].size());
+  EXPECT_EQ(80, LastFreqSample(1).time_in_state[0]);
+  ASSERT_EQ(2u, collector_.cpu_idle_state_data()[0].size());
+  EXPECT_EQ(4, LastIdleSample(0).time_in_state[0]);
+}
+
+// The history kept per CPU is bounded by the sampling period.
+TEST_F(CpuDataCollectorTest, CustomSamplePeriod) {
+  collector_.StartWithSamplePeriod(base::TimeDelta::FromSeconds(
+      PowerDataCollector::kSampleTimeLimitSec / 2));
+  StopTimer();
+  Sample();
+  EXPECT_EQ(2u, collector_.cpu_idle_state_data()[0].capacity());
+  EXPECT_EQ(2u, collector_.cpu_freq_state_data()[0].capacity());
+}
+
+}  // namespace chromeos
@@ -85,4 +85,30 @@ TEST_F(PowerDataCollectorTest, AddSample) {
             sample_deque[0].time.ToInternalValue());
 }
 
+TEST_F(PowerDataCollectorTest, CpuStateOccupancySampleBuffer) {
+  CpuDataCollector::StateOccupancySampleBuffer buffer(
+      2, base::TimeDelta::FromSeconds(PowerDataCollector::kSampleTimeLimitSec));
+  CpuDataCollector::StateOccupancySample sample;
+  sample.time = base::Time::FromInternalValue(1000);
+
+  for (int i = 0; i < 3; ++i) {
+    sample.time += base::TimeDelta::FromSeconds(1);
+    sample.time_in_state.assign(1, i);
+    buffer.Add(sample);
+  }
+
+  // The oldest sample is overwritten once the buffer is full.
+  ASSERT_EQ(static_cast<size_t>(2), buffer.size());
+  EXPECT_EQ(static_cast<int64>(1), buffer[0].time_in_state[0]);
+  EXPECT_EQ(static_cast<int64>(2), buffer[1].time_in_state[0]);
+
+  // Samples older than the time limit are dropped.
+  sample.time +=
+      base::TimeDelta::FromSeconds(PowerDataCollector::kSampleTimeLimitSec + 1);
+  sample.time_in_state.assign(1, 3);
+  buffer.Add(sample);
+  ASSERT_EQ(static_cast<size_t>(1), buffer.size());
+  EXPECT_EQ(static_cast<int64>(3), buffer[0].time_in_state[0]);
+}
+
 }  // namespace chromeos
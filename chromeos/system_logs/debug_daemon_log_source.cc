@@ -184,9 +184,14 @@ void DebugDaemonLogSource::ReadUserLogFiles(
 }
 
 void DebugDaemonLogSource::MergeResponse(SystemLogsResponse* response) {
-  for (SystemLogsResponse::const_iterator it = response->begin();
-       it != response->end(); ++it)
-    response_->insert(*it);
+  // The logs can be large; move them rather than copying.
+  for (SystemLogsResponse::iterator it = response->begin();
+       it != response->end(); ++it) {
+    std::pair<SystemLogsResponse::iterator, bool> result =
+        response_->insert(std::make_pair(it->first, std::string()));
+    if (result.second)
+      result.first->second.swap(it->second);
+  }
   RequestCompleted();
 }
 
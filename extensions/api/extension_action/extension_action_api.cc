@@ -688,7 +688,10 @@ bool ExtensionActionSetIconFunction::RunExtensionAction() {
       }
     }
 
-    extension_action_->SetIcon(tab_id_, gfx::Image(icon));
+    // Extensions animating their icon often set the same frame repeatedly;
+    // don't repaint the toolbar for those.
+    if (!extension_action_->SetIcon(tab_id_, gfx::Image(icon)))
+      return true;
   } else if (details_->GetInteger("iconIndex", &icon_index)) {
     // Obsolete argument: ignore it.
     return true;
@@ -703,8 +706,8 @@ bool ExtensionActionSetTitleFunction::RunExtensionAction() {
   EXTENSION_FUNCTION_VALIDATE(details_);
   std::string title;
   EXTENSION_FUNCTION_VALIDATE(details_->GetString("title", &title));
-  extension_action_->SetTitle(tab_id_, title);
-  NotifyChange();
+  if (extension_action_->SetTitle(tab_id_, title))
+    NotifyChange();
   return true;
 }
 
@@ -717,8 +720,8 @@ bool ExtensionActionSetPopupFunction::RunExtensionAction() {
   if (!popup_string.empty())
     popup_url = GetExtension()->GetResourceURL(popup_string);
 
-  extension_action_->SetPopupUrl(tab_id_, popup_url);
-  NotifyChange();
+  if (extension_action_->SetPopupUrl(tab_id_, popup_url))
+    NotifyChange();
   return true;
 }
 
@@ -726,8 +729,8 @@ bool ExtensionActionSetBadgeTextFunction::RunExtensionAction() {
   EXTENSION_FUNCTION_VALIDATE(details_);
   std::string badge_text;
   EXTENSION_FUNCTION_VALIDATE(details_->GetString("text", &badge_text));
-  extension_action_->SetBadgeText(tab_id_, badge_text);
-  NotifyChange();
+  if (extension_action_->SetBadgeText(tab_id_, badge_text))
+    NotifyChange();
   return true;
 }
 
@@ -755,8 +758,8 @@ bool ExtensionActionSetBadgeBackgroundColorFunction::RunExtensionAction() {
       return false;
   }
 
-  extension_action_->SetBadgeBackgroundColor(tab_id_, color);
-  NotifyChange();
+  if (extension_action_->SetBadgeBackgroundColor(tab_id_, color))
+    NotifyChange();
   return true;
 }
 
@@ -4,9 +4,12 @@
 
 #include "chrome/browser/extensions/extension_action.h"
 
+#include <string.h>
+
 #include <algorithm>
 
 #include "base/bind.h"
+#include "base/hash.h"
 #include "base/logging.h"
 #include "base/message_loop/message_loop.h"
 #include "chrome/common/badge_util.h"
@@ -50,6 +53,62 @@ class GetAttentionImageSource : public gfx::ImageSkiaSource {
   const gfx::ImageSkia icon_;
 };
 
+// Hashes the scales and pixels of all of |icon|'s representations. Each
+// pixel buffer is hashed in place and folded into the running hash.
+uint32 HashIcon(const gfx::ImageSkia& icon) {
+  uint32 hash = 0;
+  std::vector<gfx::ImageSkiaRep> reps = icon.image_reps();
+  for (size_t i = 0; i < reps.size(); ++i) {
+    const SkBitmap& bitmap = reps[i].sk_bitmap();
+    SkAutoLockPixels lock(bitmap);
+    float scale = reps[i].scale();
+    int dimensions[] = { bitmap.width(), bitmap.height() };
+    hash = hash * 31 +
+        base::Hash(reinterpret_cast<const char*>(&scale), sizeof(scale));
+    hash = hash * 31 + base::Hash(reinterpret_cast<const char*>(dimensions),
+                                  sizeof(dimensions));
+    if (bitmap.getPixels()) {
+      hash = hash * 31 +
+          base::Hash(static_cast<const char*>(bitmap.getPixels()),
+                     bitmap.getSize());
+    }
+  }
+  return hash;
+}
+
+// Returns true if |a| and |b| have the same representations with identical
+// pixels. Only used to confirm a hash match.
+bool IconsHaveSamePixels(const gfx::ImageSkia& a, const gfx::ImageSkia& b) {
+  if (a.BackedBySameObjectAs(b))
+    return true;
+  std::vector<gfx::ImageSkiaRep> a_reps = a.image_reps();
+  std::vector<gfx::ImageSkiaRep> b_reps = b.image_reps();
+  if (a_reps.size() != b_reps.size())
+    return false;
+  for (size_t i = 0; i < a_reps.size(); ++i) {
+    const SkBitmap& a_bitmap = a_reps[i].sk_bitmap();
+    const SkBitmap& b_bitmap = b_reps[i].sk_bitmap();
+    if (a_reps[i].scale() != b_reps[i].scale() ||
+        a_bitmap.width() != b_bitmap.width() ||
+        a_bitmap.height() != b_bitmap.height() ||
+        a_bitmap.getSize() != b_bitmap.getSize()) {
+      return false;
+    }
+    SkAutoLockPixels a_lock(a_bitmap);
+    SkAutoLockPixels b_lock(b_bitmap);
+    if (!a_bitmap.getPixels() || !b_bitmap.getPixels()) {
+      if (a_bitmap.getPixels() != b_bitmap.getPixels())
+        return false;
+      continue;
+    }
+    if (memcmp(a_bitmap.getPixels(), b_bitmap.getPixels(),
+               a_bitmap.getSize()) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
 template <class T>
 bool HasValue(const std::map<int, T>& map, int tab_id) {
   return map.find(tab_id) != map.end();
@@ -87,6 +146,7 @@ scoped_ptr<ExtensionAction> ExtensionAction::CopyForTest() const {
   copy->popup_url_ = popup_url_;
   copy->title_ = title_;
   copy->icon_ = icon_;
+  copy->icon_hash_ = icon_hash_;
   copy->badge_text_ = badge_text_;
   copy->badge_background_color_ = badge_background_color_;
   copy->badge_text_color_ = badge_text_color_;
@@ -115,13 +175,13 @@ int ExtensionAction::GetIconSizeForType(
   }
 }
 
-void ExtensionAction::SetPopupUrl(int tab_id, const GURL& url) {
+bool ExtensionAction::SetPopupUrl(int tab_id, const GURL& url) {
   // We store |url| even if it is empty, rather than removing a URL from the
   // map.  If an extension has a default popup, and removes it for a tab via
   // the API, we must remember that there is no popup for that specific tab.
   // If we removed the tab's URL, GetPopupURL would incorrectly return the
   // default URL.
-  SetValue(&popup_url_, tab_id, url);
+  return SetValue(&popup_url_, tab_id, url);
 }
 
 bool ExtensionAction::HasPopup(int tab_id) const {
@@ -132,8 +192,19 @@ GURL ExtensionAction::GetPopupUrl(int tab_id) const {
   return GetValue(&popup_url_, tab_id);
 }
 
-void ExtensionAction::SetIcon(int tab_id, const gfx::Image& image) {
-  SetValue(&icon_, tab_id, image.AsImageSkia());
+bool ExtensionAction::SetIcon(int tab_id, const gfx::Image& image) {
+  gfx::ImageSkia icon = image.AsImageSkia();
+  uint32 hash = HashIcon(icon);
+
+  std::map<int, gfx::ImageSkia>::const_iterator iter = icon_.find(tab_id);
+  if (iter != icon_.end() && icon_hash_[tab_id] == hash &&
+      IconsHaveSamePixels(iter->second, icon)) {
+    return false;
+  }
+
+  icon_[tab_id] = icon;
+  icon_hash_[tab_id] = hash;
+  return true;
 }
 
 gfx::ImageSkia ExtensionAction::GetExplicitlySetIcon(int tab_id) const {
@@ -167,6 +238,7 @@ void ExtensionAction::ClearAllValuesForTab(int tab_id) {
   popup_url_.erase(tab_id);
   title_.erase(tab_id);
   icon_.erase(tab_id);
+  icon_hash_.erase(tab_id);
   badge_text_.erase(tab_id);
   badge_text_color_.erase(tab_id);
   badge_background_color_.erase(tab_id);
@@ -73,7 +73,7 @@ class ExtensionAction {
 
   // Set the url which the popup will load when the user clicks this action's
   // icon.  Setting an empty URL will disable the popup for a given tab.
-  void SetPopupUrl(int tab_id, const GURL& url);
+  bool SetPopupUrl(int tab_id, const GURL& url);
 
   // Use HasPopup() to see if a popup should be displayed.
   bool HasPopup(int tab_id) const;
@@ -81,9 +81,11 @@ class ExtensionAction {
   // Get the URL to display in a popup.
   GURL GetPopupUrl(int tab_id) const;
 
-  // Set this action's title on a specific tab.
-  void SetTitle(int tab_id, const std::string& title) {
-    SetValue(&title_, tab_id, title);
+  // Set this action's title on a specific tab. The setters below return false
+  // if the tab already had an identical value, in which case observers don't
+  // need to be notified.
+  bool SetTitle(int tab_id, const std::string& title) {
+    return SetValue(&title_, tab_id, title);
   }
 
   // If tab |tab_id| has a set title, return it.  Otherwise, return
@@ -96,8 +98,10 @@ class ExtensionAction {
   // To retrieve the icon for the extension action, use
   // ExtensionActionIconFactory.
 
-  // Set this action's icon bitmap on a specific tab.
-  void SetIcon(int tab_id, const gfx::Image& image);
+  // Set this action's icon bitmap on a specific tab. Icons are compared by
+  // content, so re-setting the same pixels (as extensions animating their icon
+  // frequently do) returns false.
+  bool SetIcon(int tab_id, const gfx::Image& image);
 
   // Gets the icon that has been set using |SetIcon| for the tab.
   gfx::ImageSkia GetExplicitlySetIcon(int tab_id) const;
@@ -113,8 +117,8 @@ class ExtensionAction {
   }
 
   // Set this action's badge text on a specific tab.
-  void SetBadgeText(int tab_id, const std::string& text) {
-    SetValue(&badge_text_, tab_id, text);
+  bool SetBadgeText(int tab_id, const std::string& text) {
+    return SetValue(&badge_text_, tab_id, text);
   }
   // Get the badge text for a tab, or the default if no badge text was set.
   std::string GetBadgeText(int tab_id) const {
@@ -122,8 +126,8 @@ class ExtensionAction {
   }
 
   // Set this action's badge text color on a specific tab.
-  void SetBadgeTextColor(int tab_id, SkColor text_color) {
-    SetValue(&badge_text_color_, tab_id, text_color);
+  bool SetBadgeTextColor(int tab_id, SkColor text_color) {
+    return SetValue(&badge_text_color_, tab_id, text_color);
   }
   // Get the text color for a tab, or the default color if no text color
   // was set.
@@ -132,8 +136,8 @@ class ExtensionAction {
   }
 
   // Set this action's badge background color on a specific tab.
-  void SetBadgeBackgroundColor(int tab_id, SkColor color) {
-    SetValue(&badge_background_color_, tab_id, color);
+  bool SetBadgeBackgroundColor(int tab_id, SkColor color) {
+    return SetValue(&badge_background_color_, tab_id, color);
   }
   // Get the badge background color for a tab, or the default if no color
   // was set.
@@ -205,9 +209,15 @@ class ExtensionAction {
     }
   };
 
+  // Stores |val| for |tab_id|. Returns false if |tab_id| already had an
+  // identical value.
   template<class T>
-  void SetValue(std::map<int, T>* map, int tab_id, const T& val) {
+  bool SetValue(std::map<int, T>* map, int tab_id, const T& val) {
+    typename std::map<int, T>::iterator iter = map->find(tab_id);
+    if (iter != map->end() && iter->second == val)
+      return false;
     (*map)[tab_id] = val;
+    return true;
   }
 
   template<class Map>
@@ -242,6 +252,9 @@ class ExtensionAction {
   std::map<int, GURL> popup_url_;
   std::map<int, std::string> title_;
   std::map<int, gfx::ImageSkia> icon_;
+  // Hash of the pixels of each entry in |icon_|, used to cheaply detect an
+  // icon being set to the same image again.
+  std::map<int, uint32> icon_hash_;
   std::map<int, std::string> badge_text_;
   std::map<int, SkColor> badge_background_color_;
   std::map<int, SkColor> badge_text_color_;
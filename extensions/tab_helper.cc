@@ -338,6 +338,29 @@ void TabHelper::DidCloneToNewWebContents(WebContents* old_web_contents,
   new_helper->extension_app_icon_ = extension_app_icon_;
 }
 
+void TabHelper::WebContentsDestroyed() {
+  // Drop the per-tab state extensions set on their actions for this tab, so
+  // that actions updated on many short-lived tabs don't accumulate entries.
+  // No notification is needed since the tab's views are going away.
+  int tab_id = SessionID::IdForTab(web_contents());
+  ExtensionActionManager* extension_action_manager =
+      ExtensionActionManager::Get(profile_);
+  const ExtensionSet& enabled_extensions =
+      ExtensionRegistry::Get(profile_)->enabled_extensions();
+  for (ExtensionSet::const_iterator it = enabled_extensions.begin();
+       it != enabled_extensions.end();
+       ++it) {
+    ExtensionAction* browser_action =
+        extension_action_manager->GetBrowserAction(*it->get());
+    if (browser_action)
+      browser_action->ClearAllValuesForTab(tab_id);
+    ExtensionAction* page_action =
+        extension_action_manager->GetPageAction(*it->get());
+    if (page_action)
+      page_action->ClearAllValuesForTab(tab_id);
+  }
+}
+
 void TabHelper::OnDidGetApplicationInfo(int32 page_id,
                                         const WebApplicationInfo& info) {
   // Android does not implement BrowserWindow.
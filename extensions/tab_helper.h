@@ -185,6 +185,7 @@ class TabHelper : public content::WebContentsObserver,
   virtual void DidCloneToNewWebContents(
       content::WebContents* old_web_contents,
       content::WebContents* new_web_contents) OVERRIDE;
+  virtual void WebContentsDestroyed() OVERRIDE;
 
   // extensions::ExtensionFunctionDispatcher::Delegate overrides.
   virtual extensions::WindowController* GetExtensionWindowController()
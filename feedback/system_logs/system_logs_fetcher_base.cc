@@ -6,15 +6,27 @@
 
 #include "base/bind.h"
 #include "base/bind_helpers.h"
+#include "base/callback_helpers.h"
+#include "base/metrics/histogram.h"
 #include "content/public/browser/browser_thread.h"
 
 using content::BrowserThread;
 
 namespace system_logs {
 
+namespace {
+
+// How long to wait for all the sources before sending what has been gathered.
+// Most sources respond within a second; this bounds how long a hung source
+// (e.g. debugd) can hold up a feedback report.
+const int kFetchTimeoutSeconds = 30;
+
+}  // namespace
+
 SystemLogsFetcherBase::SystemLogsFetcherBase()
     : response_(new SystemLogsResponse),
-      num_pending_requests_(0) {
+      num_pending_requests_(0),
+      fetch_timeout_(base::TimeDelta::FromSeconds(kFetchTimeoutSeconds)) {
 }
 
 SystemLogsFetcherBase::~SystemLogsFetcherBase() {}
@@ -25,6 +37,18 @@ void SystemLogsFetcherBase::Fetch(const SysLogsFetcherCallback& callback) {
   DCHECK(!callback.is_null());
 
   callback_ = callback;
+  fetch_start_time_ = base::TimeTicks::Now();
+  if (data_sources_.empty()) {
+    // No source will ever call AddResponse(), so finish now rather than
+    // waiting for the timeout.
+    RunCallback();
+    BrowserThread::DeleteSoon(BrowserThread::UI, FROM_HERE, this);
+    return;
+  }
+  timeout_timer_.Start(FROM_HERE,
+                       fetch_timeout_,
+                       this,
+                       &SystemLogsFetcherBase::OnFetchTimeout);
   for (size_t i = 0; i < data_sources_.size(); ++i) {
     data_sources_[i]->Fetch(base::Bind(&SystemLogsFetcherBase::AddResponse,
                                        AsWeakPtr()));
@@ -34,20 +58,45 @@ void SystemLogsFetcherBase::Fetch(const SysLogsFetcherCallback& callback) {
 void SystemLogsFetcherBase::AddResponse(SystemLogsResponse* response) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
 
-  for (SystemLogsResponse::const_iterator it = response->begin();
-       it != response->end();
-       ++it) {
-    // It is an error to insert an element with a pre-existing key.
-    bool ok = response_->insert(*it).second;
-    DCHECK(ok) << "Duplicate key found: " << it->first;
+  // |response_| is gone if the logs were already sent because of a timeout.
+  if (response_) {
+    for (SystemLogsResponse::iterator it = response->begin();
+         it != response->end();
+         ++it) {
+      // It is an error to insert an element with a pre-existing key.
+      std::pair<SystemLogsResponse::iterator, bool> result =
+          response_->insert(std::make_pair(it->first, std::string()));
+      DCHECK(result.second) << "Duplicate key found: " << it->first;
+      // Logs can be several megabytes, so take them over instead of copying;
+      // sources don't use their response after handing it to us.
+      if (result.second)
+        result.first->second.swap(it->second);
+    }
   }
 
   --num_pending_requests_;
   if (num_pending_requests_ > 0)
     return;
 
-  callback_.Run(response_.Pass());
+  if (response_) {
+    timeout_timer_.Stop();
+    RunCallback();
+  }
   BrowserThread::DeleteSoon(BrowserThread::UI, FROM_HERE, this);
 }
 
+void SystemLogsFetcherBase::OnFetchTimeout() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  DCHECK_GT(num_pending_requests_, 0u);
+  UMA_HISTOGRAM_COUNTS_100("Feedback.SystemLogs.TimedOutSources",
+                           num_pending_requests_);
+  RunCallback();
+}
+
+void SystemLogsFetcherBase::RunCallback() {
+  UMA_HISTOGRAM_MEDIUM_TIMES("Feedback.SystemLogs.FetchTime",
+                             base::TimeTicks::Now() - fetch_start_time_);
+  base::ResetAndReturn(&callback_).Run(response_.Pass());
+}
+
 }  // namespace system_logs
@@ -11,6 +11,8 @@
 #include "base/callback.h"
 #include "base/memory/scoped_vector.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 
 namespace system_logs {
 
@@ -38,6 +40,11 @@ class SystemLogsSource {
 // Derived LogFetcher classes aggregate the logs from a list of SystemLogSource
 // classes.
 //
+// All sources are queried at the same time. If some of them haven't responded
+// within a timeout, the logs gathered so far are returned without them; the
+// fetcher then stays around until the remaining sources respond, dropping
+// their data.
+//
 // EXAMPLE:
 // class Example {
 //  public:
@@ -63,13 +70,25 @@ class SystemLogsFetcherBase
   // deletes this instance of the object.
   void AddResponse(SystemLogsResponse* response);
 
+  // Called when the sources took too long to respond. Returns the partial
+  // response to the callback_.
+  void OnFetchTimeout();
+
   ScopedVector<SystemLogsSource> data_sources_;
   SysLogsFetcherCallback callback_;
 
   scoped_ptr<SystemLogsResponse> response_;  // The actual response data.
   size_t num_pending_requests_;   // The number of callbacks it should get.
 
+  // How long to wait for the sources before returning a partial response.
+  base::TimeDelta fetch_timeout_;
+
  private:
+  // Passes |response_| to |callback_|.
+  void RunCallback();
+
+  base::TimeTicks fetch_start_time_;
+  base::OneShotTimer<SystemLogsFetcherBase> timeout_timer_;
 
   DISALLOW_COPY_AND_ASSIGN(SystemLogsFetcherBase);
 };
@@ -0,0 +1,168 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/feedback/system_logs/system_logs_fetcher_base.h"
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/run_loop.h"
+#include "content/public/test/test_browser_thread_bundle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace system_logs {
+
+namespace {
+
+// Responds with a single entry as soon as it is asked.
+class ImmediateSource : public SystemLogsSource {
+ public:
+  ImmediateSource(const std::string& key, const std::string& value) {
+    response_[key] = value;
+  }
+  virtual ~ImmediateSource() {}
+
+  virtual void Fetch(const SysLogsSourceCallback& callback) OVERRIDE {
+    callback.Run(&response_);
+  }
+
+  const SystemLogsResponse& response() const { return response_; }
+
+ private:
+  SystemLogsResponse response_;
+
+  DISALLOW_COPY_AND_ASSIGN(ImmediateSource);
+};
+
+// Only responds when the test tells it to. Sets |*deleted| when the fetcher
+// that owns it is destroyed.
+class DelayedSource : public SystemLogsSource {
+ public:
+  DelayedSource(const std::string& key, bool* deleted) : deleted_(deleted) {
+    response_[key] = "late";
+  }
+  virtual ~DelayedSource() { *deleted_ = true; }
+
+  virtual void Fetch(const SysLogsSourceCallback& callback) OVERRIDE {
+    callback_ = callback;
+  }
+
+  void Respond() { callback_.Run(&response_); }
+
+ private:
+  SystemLogsResponse response_;
+  SysLogsSourceCallback callback_;
+  bool* deleted_;
+
+  DISALLOW_COPY_AND_ASSIGN(DelayedSource);
+};
+
+class TestSystemLogsFetcher : public SystemLogsFetcherBase {
+ public:
+  // Takes ownership of |sources|. A zero timeout fires as soon as the message
+  // loop runs.
+  explicit TestSystemLogsFetcher(
+      const std::vector<SystemLogsSource*>& sources) {
+    data_sources_.insert(data_sources_.end(), sources.begin(), sources.end());
+    num_pending_requests_ = data_sources_.size();
+    fetch_timeout_ = base::TimeDelta();
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(TestSystemLogsFetcher);
+};
+
+}  // namespace
+
+class SystemLogsFetcherBaseTest : public testing::Test {
+ public:
+  SystemLogsFetcherBaseTest() : callback_count_(0) {}
+
+ protected:
+  void Fetch(const std::vector<SystemLogsSource*>& sources) {
+    // Deletes itself once all the sources have responded.
+    TestSystemLogsFetcher* fetcher = new TestSystemLogsFetcher(sources);
+    fetcher->Fetch(base::Bind(&SystemLogsFetcherBaseTest::OnLogsFetched,
+                              base::Unretained(this)));
+  }
+
+  void OnLogsFetched(scoped_ptr<SystemLogsResponse> response) {
+    ++callback_count_;
+    response_ = response.Pass();
+  }
+
+  int callback_count_;
+  scoped_ptr<SystemLogsResponse> response_;
+
+ private:
+  content::TestBrowserThreadBundle thread_bundle_;
+};
+
+// The responses of all the sources are merged, taking over their data rather
+// than copying it.
+TEST_F(SystemLogsFetcherBaseTest, MergesResponses) {
+  bool deleted = false;
+  ImmediateSource* source = new ImmediateSource("a", "first");
+  DelayedSource* delayed_source = new DelayedSource("b", &deleted);
+  std::vector<SystemLogsSource*> sources;
+  sources.push_back(source);
+  sources.push_back(delayed_source);
+  Fetch(sources);
+
+  EXPECT_EQ(0, callback_count_);
+  EXPECT_EQ("", source->response().find("a")->second);
+  delayed_source->Respond();
+  ASSERT_EQ(1, callback_count_);
+  ASSERT_EQ(2u, response_->size());
+  EXPECT_EQ("first", (*response_)["a"]);
+  EXPECT_EQ("late", (*response_)["b"]);
+
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(deleted);
+}
+
+// Sources that haven't responded by the timeout are left out, and their late
+// responses are dropped.
+TEST_F(SystemLogsFetcherBaseTest, TimeoutReturnsPartialResponse) {
+  bool first_deleted = false;
+  bool second_deleted = false;
+  DelayedSource* first = new DelayedSource("late1", &first_deleted);
+  DelayedSource* second = new DelayedSource("late2", &second_deleted);
+  std::vector<SystemLogsSource*> sources;
+  sources.push_back(new ImmediateSource("a", "first"));
+  sources.push_back(first);
+  sources.push_back(second);
+  Fetch(sources);
+
+  EXPECT_EQ(0, callback_count_);
+  base::RunLoop().RunUntilIdle();
+  ASSERT_EQ(1, callback_count_);
+  ASSERT_EQ(1u, response_->size());
+  EXPECT_EQ("first", (*response_)["a"]);
+
+  // The fetcher outlives the timeout until the last source has responded.
+  first->Respond();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_FALSE(first_deleted);
+
+  second->Respond();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(second_deleted);
+  EXPECT_EQ(1, callback_count_);
+  EXPECT_EQ(1u, response_->size());
+}
+
+// A fetcher without sources returns an empty response right away instead of
+// waiting for the timeout.
+TEST_F(SystemLogsFetcherBaseTest, NoSources) {
+  Fetch(std::vector<SystemLogsSource*>());
+  ASSERT_EQ(1, callback_count_);
+  EXPECT_TRUE(response_->empty());
+
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(1, callback_count_);
+}
+
+}  // namespace system_logs
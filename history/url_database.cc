@@ -10,6 +10,8 @@
 #include <vector>
 
 #include "base/i18n/case_conversion.h"
+#include "base/lazy_instance.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "chrome/common/url_constants.h"
 #include "net/base/net_util.h"
@@ -19,6 +21,48 @@
 
 namespace history {
 
+namespace {
+
+// The number of prefixes AutocompleteForPrefixes() looks up per statement.
+// This covers every URLPrefix the omnibox tries, so a lookup normally takes a
+// single statement.
+const size_t kAutocompletePrefixesPerStatement = 8;
+
+// The column holding the prefix index in the AutocompleteForPrefixes()
+// statement; it follows the HISTORY_URL_ROW_FIELDS columns.
+const int kAutocompletePrefixIndexColumn = 7;
+
+// Returns a UNION ALL of kAutocompletePrefixesPerStatement copies of the
+// AutocompleteForPrefix() query, each tagged with its position. Every copy
+// binds a range start, a range end, a minimum typed count, and a limit.
+std::string BuildAutocompleteForPrefixesSQL() {
+  std::string sql;
+  for (size_t i = 0; i < kAutocompletePrefixesPerStatement; ++i) {
+    if (i > 0)
+      sql.append(" UNION ALL ");
+    sql.append("SELECT * FROM (SELECT" HISTORY_URL_ROW_FIELDS ", ");
+    sql.append(base::Uint64ToString(i));
+    sql.append(" FROM urls WHERE url >= ? AND url < ? AND hidden = 0 "
+               "AND typed_count >= ? "
+               "ORDER BY typed_count DESC, visit_count DESC, "
+               "last_visit_time DESC LIMIT ?)");
+  }
+  return sql;
+}
+
+// The AutocompleteForPrefixes() statement, built once rather than on every
+// keystroke. Several history threads can look it up, so it is a LazyInstance.
+struct AutocompleteForPrefixesSQL {
+  AutocompleteForPrefixesSQL() : sql(BuildAutocompleteForPrefixesSQL()) {}
+
+  const std::string sql;
+};
+
+base::LazyInstance<AutocompleteForPrefixesSQL>::Leaky
+    g_autocomplete_for_prefixes_sql = LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
 const char URLDatabase::kURLRowFields[] = HISTORY_URL_ROW_FIELDS;
 const int URLDatabase::kNumURLRowFields = 9;
 
@@ -311,6 +355,50 @@ bool URLDatabase::AutocompleteForPrefix(const std::string& prefix,
   return !results->empty();
 }
 
+bool URLDatabase::AutocompleteForPrefixes(
+    const std::vector<std::string>& prefixes,
+    size_t max_results,
+    bool typed_only,
+    PrefixedURLRows* results) {
+  // The statement is cached, so |sql| is only compiled on the first call.
+  const std::string& sql = g_autocomplete_for_prefixes_sql.Get().sql;
+  results->clear();
+  for (size_t first = 0; first < prefixes.size();
+       first += kAutocompletePrefixesPerStatement) {
+    sql::Statement statement(
+        GetDB().GetCachedStatement(SQL_FROM_HERE, sql.c_str()));
+    for (size_t i = 0; i < kAutocompletePrefixesPerStatement; ++i) {
+      const int param = static_cast<int>(i) * 4;
+      if (first + i < prefixes.size()) {
+        // See AutocompleteForPrefix() for how the range end is formed.
+        const std::string& prefix = prefixes[first + i];
+        std::string end_query(prefix);
+        end_query.push_back(std::numeric_limits<unsigned char>::max());
+        statement.BindString(param, prefix);
+        statement.BindString(param + 1, end_query);
+        statement.BindInt(param + 3, static_cast<int>(max_results));
+      } else {
+        // Unused slot; an empty range with no rows.
+        statement.BindString(param, std::string());
+        statement.BindString(param + 1, std::string());
+        statement.BindInt(param + 3, 0);
+      }
+      statement.BindInt(param + 2, typed_only ? 1 : 0);
+    }
+
+    while (statement.Step()) {
+      history::URLRow info;
+      FillURLRow(statement, &info);
+      if (info.url().is_valid()) {
+        results->push_back(std::make_pair(
+            info,
+            first + statement.ColumnInt(kAutocompletePrefixIndexColumn)));
+      }
+    }
+  }
+  return !results->empty();
+}
+
 bool URLDatabase::IsTypedHost(const std::string& host) {
   const char* schemes[] = {
     url::kHttpScheme,
@@ -5,6 +5,10 @@
 #ifndef CHROME_BROWSER_HISTORY_URL_DATABASE_H_
 #define CHROME_BROWSER_HISTORY_URL_DATABASE_H_
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "base/basictypes.h"
 #include "chrome/browser/history/history_types.h"
 #include "chrome/browser/search_engines/template_url_id.h"
@@ -168,6 +172,20 @@ class URLDatabase {
                              bool typed_only,
                              URLRows* results);
 
+  // A row found by AutocompleteForPrefixes(), paired with the index of the
+  // prefix it was found for.
+  typedef std::vector<std::pair<URLRow, size_t> > PrefixedURLRows;
+
+  // Like calling AutocompleteForPrefix() once for each entry of |prefixes|,
+  // but runs the lookups together in as few statements as possible instead of
+  // one statement per prefix. Up to |max_results| rows are returned for each
+  // prefix, grouped by prefix in the order of |prefixes|. A row that matches
+  // several prefixes is returned once for each of them.
+  bool AutocompleteForPrefixes(const std::vector<std::string>& prefixes,
+                               size_t max_results,
+                               bool typed_only,
+                               PrefixedURLRows* results);
+
   // Returns true if the database holds some past typed navigation to a URL on
   // the provided hostname.
   bool IsTypedHost(const std::string& host);
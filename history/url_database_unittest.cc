@@ -5,11 +5,13 @@
 #include "base/files/file_path.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "chrome/browser/history/url_database.h"
 #include "sql/connection.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
 
 using base::Time;
 using base::TimeDelta;
@@ -30,6 +32,12 @@ bool IsURLRowEqual(const URLRow& a,
       a.hidden() == b.hidden();
 }
 
+// The scheme and "www." variants the omnibox looks history up with.
+const char* const kAutocompletePrefixes[] = {
+  "https://www.", "http://www.", "ftp://ftp.", "ftp://www.",
+  "https://", "http://", "ftp://", "",
+};
+
 }  // namespace
 
 class URLDatabaseTest : public testing::Test,
@@ -249,6 +257,109 @@ TEST_F(URLDatabaseTest, EnumeratorForSignificant) {
   EXPECT_EQ(3, row_count);
 }
 
+// Tests that AutocompleteForPrefixes() finds the same rows as one
+// AutocompleteForPrefix() call per prefix.
+TEST_F(URLDatabaseTest, AutocompleteForPrefixes) {
+  const char* urls[] = {
+    "http://www.foo.com/", "https://www.foo.com/", "http://foo.com/",
+    "http://foobar.com/", "ftp://ftp.foo.com/", "http://www.www.foo.com/",
+    "http://bar.com/",
+  };
+  for (size_t i = 0; i < arraysize(urls); ++i) {
+    URLRow row((GURL(urls[i])));
+    row.set_visit_count(static_cast<int>(i) + 1);
+    row.set_typed_count(i % 2);
+    ASSERT_TRUE(AddURL(row));
+  }
+
+  const char* inputs[] = { "foo", "www.foo", "http://f", "b" };
+  for (size_t i = 0; i < arraysize(inputs); ++i) {
+    std::vector<std::string> prefixes;
+    for (size_t j = 0; j < arraysize(kAutocompletePrefixes); ++j)
+      prefixes.push_back(std::string(kAutocompletePrefixes[j]) + inputs[i]);
+    // Also cover a second statement's worth of prefixes.
+    prefixes.push_back(std::string("http://") + inputs[i]);
+
+    for (int typed_only = 0; typed_only < 2; ++typed_only) {
+      SCOPED_TRACE(std::string(inputs[i]) + (typed_only ? " typed" : ""));
+      PrefixedURLRows combined;
+      AutocompleteForPrefixes(prefixes, 2, typed_only != 0, &combined);
+
+      PrefixedURLRows expected;
+      for (size_t j = 0; j < prefixes.size(); ++j) {
+        URLRows rows;
+        AutocompleteForPrefix(prefixes[j], 2, typed_only != 0, &rows);
+        for (URLRows::const_iterator row = rows.begin(); row != rows.end();
+             ++row)
+          expected.push_back(std::make_pair(*row, j));
+      }
+
+      ASSERT_EQ(expected.size(), combined.size());
+      for (size_t j = 0; j < expected.size(); ++j) {
+        EXPECT_EQ(expected[j].first.url(), combined[j].first.url());
+        EXPECT_EQ(expected[j].second, combined[j].second);
+      }
+    }
+  }
+}
+
+// Compares one AutocompleteForPrefix() call per prefix against a single
+// AutocompleteForPrefixes() call over a large synthetic history. This is
+// manual as it inserts 100000 rows and only reports timings; the
+// AutocompleteForPrefixes test covers the results.
+TEST_F(URLDatabaseTest, MANUAL_AutocompleteForPrefixesPerf) {
+  const int kURLCount = 100000;
+  const char* schemes[] = { "http://", "https://", "http://www.", "ftp://" };
+  ASSERT_TRUE(GetDB().BeginTransaction());
+  for (int i = 0; i < kURLCount; ++i) {
+    URLRow row(GURL(std::string(schemes[i % arraysize(schemes)]) + "host" +
+                    base::IntToString(i / 7) + ".com/" +
+                    base::IntToString(i % 7)));
+    row.set_visit_count(i % 13);
+    row.set_typed_count(i % 3);
+    ASSERT_TRUE(AddURL(row));
+  }
+  ASSERT_TRUE(GetDB().CommitTransaction());
+
+  const std::string kInput = "host1234";
+  const size_t kMaxResults = 6;
+  base::TimeDelta separate_time;
+  base::TimeDelta combined_time;
+  size_t separate_rows = 0;
+  size_t combined_rows = 0;
+  for (size_t length = 1; length <= kInput.size(); ++length) {
+    std::vector<std::string> prefixes;
+    for (size_t j = 0; j < arraysize(kAutocompletePrefixes); ++j) {
+      prefixes.push_back(std::string(kAutocompletePrefixes[j]) +
+                         kInput.substr(0, length));
+    }
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    URLRows rows;
+    for (size_t j = 0; j < prefixes.size(); ++j) {
+      AutocompleteForPrefix(prefixes[j], kMaxResults, false, &rows);
+      separate_rows += rows.size();
+    }
+    separate_time += base::TimeTicks::Now() - start;
+
+    start = base::TimeTicks::Now();
+    PrefixedURLRows prefixed_rows;
+    AutocompleteForPrefixes(prefixes, kMaxResults, false, &prefixed_rows);
+    combined_rows += prefixed_rows.size();
+    combined_time += base::TimeTicks::Now() - start;
+  }
+
+  EXPECT_EQ(separate_rows, combined_rows);
+  perf_test::PrintResult(
+      "url_database_autocomplete", "", "separate_queries",
+      separate_time.InMicroseconds() / static_cast<double>(kInput.size()),
+      "us", true);
+  perf_test::PrintResult(
+      "url_database_autocomplete", "", "combined_query",
+      combined_time.InMicroseconds() / static_cast<double>(kInput.size()),
+      "us", true);
+}
+
 // Test GetKeywordSearchTermRows and DeleteSearchTerm
 TEST_F(URLDatabaseTest, GetAndDeleteKeywordSearchTermByTerm) {
   URLRow url_info1(GURL("http://www.google.com/"));
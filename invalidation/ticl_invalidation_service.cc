@@ -19,6 +19,9 @@
 #include "sync/notifier/non_blocking_invalidator.h"
 #include "sync/notifier/object_id_invalidation_map.h"
 
+// How long incoming invalidations are collected before they are dispatched.
+static const int kInvalidationBatchDelayMs = 200;
+
 static const char* kOAuth2Scopes[] = {
   GaiaConstants::kGoogleTalkOAuth2Scope
 };
@@ -295,7 +298,26 @@ void TiclInvalidationService::OnInvalidatorStateChange(
 
 void TiclInvalidationService::OnIncomingInvalidation(
     const syncer::ObjectIdInvalidationMap& invalidation_map) {
-  invalidator_registrar_->DispatchInvalidationsToHandlers(invalidation_map);
+  syncer::ObjectIdSet ids = invalidation_map.GetObjectIds();
+  for (syncer::ObjectIdSet::const_iterator id = ids.begin(); id != ids.end();
+       ++id) {
+    const syncer::SingleObjectInvalidationSet& list =
+        invalidation_map.ForObject(*id);
+    for (syncer::SingleObjectInvalidationSet::const_iterator it =
+             list.begin();
+         it != list.end(); ++it) {
+      AddPendingInvalidation(*it);
+    }
+  }
+  // The batch is bounded by its first invalidation, so a steady stream of
+  // invalidations can't postpone dispatching indefinitely.
+  if (!dispatch_invalidations_timer_.IsRunning()) {
+    dispatch_invalidations_timer_.Start(
+        FROM_HERE,
+        base::TimeDelta::FromMilliseconds(kInvalidationBatchDelayMs),
+        this,
+        &TiclInvalidationService::DispatchPendingInvalidations);
+  }
 
   logger_.OnInvalidation(invalidation_map);
 }
@@ -304,6 +326,10 @@ std::string TiclInvalidationService::GetOwnerName() const { return "TICL"; }
 
 void TiclInvalidationService::Shutdown() {
   DCHECK(CalledOnValidThread());
+  // Undispatched invalidations haven't been acknowledged, so the invalidation
+  // client will deliver them again.
+  dispatch_invalidations_timer_.Stop();
+  pending_invalidations_.clear();
   settings_provider_->RemoveObserver(this);
   identity_provider_->RemoveActiveAccountRefreshTokenObserver(this);
   identity_provider_->RemoveObserver(this);
@@ -439,4 +465,42 @@ void TiclInvalidationService::StopInvalidator() {
   invalidator_.reset();
 }
 
+void TiclInvalidationService::AddPendingInvalidation(
+    const syncer::Invalidation& invalidation) {
+  std::vector<syncer::Invalidation>& pending =
+      pending_invalidations_[invalidation.object_id()];
+  for (std::vector<syncer::Invalidation>::iterator it = pending.begin();
+       it != pending.end(); ++it) {
+    if (it->is_unknown_version() != invalidation.is_unknown_version())
+      continue;
+    // An unknown-version invalidation carries no information beyond the one
+    // already pending, and a known version is subsumed by a higher one.
+    // Acknowledge the redundant invalidation so it isn't redelivered.
+    if (invalidation.is_unknown_version() ||
+        invalidation.version() <= it->version()) {
+      invalidation.Acknowledge();
+    } else {
+      it->Acknowledge();
+      *it = invalidation;
+    }
+    return;
+  }
+  pending.push_back(invalidation);
+}
+
+void TiclInvalidationService::DispatchPendingInvalidations() {
+  dispatch_invalidations_timer_.Stop();
+  if (pending_invalidations_.empty())
+    return;
+  syncer::ObjectIdInvalidationMap invalidation_map;
+  for (PendingInvalidationsMap::const_iterator it =
+           pending_invalidations_.begin();
+       it != pending_invalidations_.end(); ++it) {
+    for (size_t i = 0; i < it->second.size(); ++i)
+      invalidation_map.Insert(it->second[i]);
+  }
+  pending_invalidations_.clear();
+  invalidator_registrar_->DispatchInvalidationsToHandlers(invalidation_map);
+}
+
 }  // namespace invalidation
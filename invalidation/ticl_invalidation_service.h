@@ -5,7 +5,9 @@
 #ifndef CHROME_BROWSER_INVALIDATION_TICL_INVALIDATION_SERVICE_H_
 #define CHROME_BROWSER_INVALIDATION_TICL_INVALIDATION_SERVICE_H_
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include "base/compiler_specific.h"
 #include "base/macros.h"
@@ -21,7 +23,9 @@
 #include "google_apis/gaia/identity_provider.h"
 #include "google_apis/gaia/oauth2_token_service.h"
 #include "net/base/backoff_entry.h"
+#include "sync/internal_api/public/base/invalidation.h"
 #include "sync/notifier/invalidation_handler.h"
+#include "sync/notifier/invalidation_util.h"
 #include "sync/notifier/invalidator_registrar.h"
 
 namespace gcm {
@@ -134,6 +138,14 @@ class TiclInvalidationService : public base::NonThreadSafe,
   void UpdateInvalidatorCredentials();
   void StopInvalidator();
 
+  // Adds |invalidation| to |pending_invalidations_|, acknowledging whichever
+  // of it and an already pending invalidation for the same object is made
+  // redundant by the other.
+  void AddPendingInvalidation(const syncer::Invalidation& invalidation);
+
+  // Hands all pending invalidations to the handlers as one batch.
+  void DispatchPendingInvalidations();
+
   scoped_ptr<IdentityProvider> identity_provider_;
   scoped_ptr<TiclSettingsProvider> settings_provider_;
 
@@ -141,6 +153,18 @@ class TiclInvalidationService : public base::NonThreadSafe,
   scoped_ptr<syncer::InvalidationStateTracker> invalidation_state_tracker_;
   scoped_ptr<syncer::Invalidator> invalidator_;
 
+  // Invalidations received from |invalidator_| that have not been dispatched
+  // yet. Invalidations arriving in a burst are collected here and dispatched
+  // together once |dispatch_invalidations_timer_| fires, so that handlers see
+  // one batch instead of reacting to each invalidation. For each object, at
+  // most the highest known version and one unknown-version invalidation are
+  // kept.
+  typedef std::map<invalidation::ObjectId,
+                   std::vector<syncer::Invalidation>,
+                   syncer::ObjectIdLessThan> PendingInvalidationsMap;
+  PendingInvalidationsMap pending_invalidations_;
+  base::OneShotTimer<TiclInvalidationService> dispatch_invalidations_timer_;
+
   // TiclInvalidationService needs to remember access token in order to
   // invalidate it with OAuth2TokenService.
   std::string access_token_;
@@ -14,6 +14,7 @@
 #include "google_apis/gaia/fake_identity_provider.h"
 #include "google_apis/gaia/fake_oauth2_token_service.h"
 #include "net/url_request/url_request_context_getter.h"
+#include "sync/notifier/fake_invalidation_handler.h"
 #include "sync/notifier/fake_invalidation_state_tracker.h"
 #include "sync/notifier/fake_invalidator.h"
 #include "sync/notifier/invalidation_state_tracker.h"
@@ -93,6 +94,11 @@ class TiclInvalidationServiceTestDelegate {
   void TriggerOnIncomingInvalidation(
       const syncer::ObjectIdInvalidationMap& invalidation_map) {
     fake_invalidator_->EmitOnIncomingInvalidation(invalidation_map);
+    DispatchPendingInvalidations();
+  }
+
+  void DispatchPendingInvalidations() {
+    invalidation_service_->DispatchPendingInvalidations();
   }
 
   FakeOAuth2TokenService token_service_;
@@ -147,4 +153,51 @@ TEST(TiclInvalidationServiceLoggingTest, DetailedStatusCallbacksWork) {
   EXPECT_TRUE(fake_container.called_);
 }
 
+// Test that invalidations arriving in a burst are dispatched as one batch,
+// keeping only the highest version and one unknown-version invalidation per
+// object.
+TEST(TiclInvalidationServiceBatchingTest, BurstIsCoalesced) {
+  content::TestBrowserThreadBundle thread_bundle;
+  TiclInvalidationServiceTestDelegate delegate;
+  delegate.CreateInvalidationService();
+  InvalidationService* const invalidator = delegate.GetInvalidationService();
+
+  const invalidation::ObjectId id1(
+      ipc::invalidation::ObjectSource::CHROME_SYNC, "BOOKMARK");
+  const invalidation::ObjectId id2(
+      ipc::invalidation::ObjectSource::CHROME_SYNC, "PREFERENCE");
+  syncer::FakeInvalidationHandler handler;
+  invalidator->RegisterInvalidationHandler(&handler);
+  syncer::ObjectIdSet ids;
+  ids.insert(id1);
+  ids.insert(id2);
+  invalidator->UpdateRegisteredInvalidationIds(&handler, ids);
+  delegate.TriggerOnInvalidatorStateChange(syncer::INVALIDATIONS_ENABLED);
+
+  const syncer::Invalidation invalidations[] = {
+    syncer::Invalidation::Init(id1, 1, "1"),
+    syncer::Invalidation::Init(id1, 3, "3"),
+    syncer::Invalidation::Init(id1, 2, "2"),
+    syncer::Invalidation::InitUnknownVersion(id2),
+    syncer::Invalidation::InitUnknownVersion(id2),
+  };
+  for (size_t i = 0; i < arraysize(invalidations); ++i) {
+    syncer::ObjectIdInvalidationMap invalidation_map;
+    invalidation_map.Insert(invalidations[i]);
+    delegate.fake_invalidator_->EmitOnIncomingInvalidation(invalidation_map);
+  }
+  EXPECT_EQ(0, handler.GetInvalidationCount());
+
+  delegate.DispatchPendingInvalidations();
+  EXPECT_EQ(1, handler.GetInvalidationCount());
+  const syncer::ObjectIdInvalidationMap& dispatched =
+      handler.GetLastInvalidationMap();
+  ASSERT_EQ(1U, dispatched.ForObject(id1).GetSize());
+  EXPECT_EQ(3, dispatched.ForObject(id1).begin()->version());
+  ASSERT_EQ(1U, dispatched.ForObject(id2).GetSize());
+  EXPECT_TRUE(dispatched.ForObject(id2).StartsWithUnknownVersion());
+
+  invalidator->UnregisterInvalidationHandler(&handler);
+}
+
 }  // namespace invalidation
@@ -4,6 +4,8 @@
 
 #include "chrome/browser/managed_mode/managed_mode_url_filter.h"
 
+#include <algorithm>
+
 #include "base/containers/hash_tables.h"
 #include "base/files/file_path.h"
 #include "base/json/json_file_value_serializer.h"
@@ -28,7 +30,104 @@ using policy::URLBlacklist;
 using url_matcher::URLMatcher;
 using url_matcher::URLMatcherConditionSet;
 
+// A trie over the dot-separated labels of hostnames, last label first. Each
+// entry matches either exactly its host, or its host and all subdomains, and
+// carries an integer value. A lookup walks the labels of a host once and
+// collects the values of all entries that match it.
+class ManagedModeURLFilter::HostTrie {
+ public:
+  HostTrie();
+  ~HostTrie();
+
+  // Adds |host|, which is taken literally. If |match_subdomains| is true, the
+  // entry matches subdomains of |host| as well.
+  void Add(const std::string& host, bool match_subdomains, int value);
+
+  // Appends the values of all entries matching |host| to |values|.
+  void GetMatches(const std::string& host, std::vector<int>* values) const;
+
+  bool empty() const { return nodes_.size() == 1; }
+
+ private:
+  struct Node {
+    std::map<std::string, size_t> children;
+    // Values of entries for exactly this host.
+    std::vector<int> exact_values;
+    // Values of entries for this host and its subdomains.
+    std::vector<int> subdomain_values;
+  };
+
+  // All nodes, referring to their children by index. The root is nodes_[0].
+  std::vector<Node> nodes_;
+
+  DISALLOW_COPY_AND_ASSIGN(HostTrie);
+};
+
+ManagedModeURLFilter::HostTrie::HostTrie() : nodes_(1) {}
+
+ManagedModeURLFilter::HostTrie::~HostTrie() {}
+
+void ManagedModeURLFilter::HostTrie::Add(const std::string& host,
+                                         bool match_subdomains,
+                                         int value) {
+  size_t node = 0;
+  size_t end = host.length();
+  while (true) {
+    size_t dot = end == 0 ? std::string::npos : host.rfind('.', end - 1);
+    size_t begin = dot == std::string::npos ? 0 : dot + 1;
+    std::string label = host.substr(begin, end - begin);
+    std::map<std::string, size_t>::const_iterator it =
+        nodes_[node].children.find(label);
+    if (it == nodes_[node].children.end()) {
+      size_t child = nodes_.size();
+      nodes_.push_back(Node());
+      nodes_[node].children[label] = child;
+      node = child;
+    } else {
+      node = it->second;
+    }
+    if (dot == std::string::npos)
+      break;
+    end = dot;
+  }
+
+  if (match_subdomains)
+    nodes_[node].subdomain_values.push_back(value);
+  else
+    nodes_[node].exact_values.push_back(value);
+}
+
+void ManagedModeURLFilter::HostTrie::GetMatches(
+    const std::string& host,
+    std::vector<int>* values) const {
+  size_t node = 0;
+  size_t end = host.length();
+  while (true) {
+    size_t dot = end == 0 ? std::string::npos : host.rfind('.', end - 1);
+    size_t begin = dot == std::string::npos ? 0 : dot + 1;
+    std::map<std::string, size_t>::const_iterator it =
+        nodes_[node].children.find(host.substr(begin, end - begin));
+    if (it == nodes_[node].children.end())
+      return;
+    node = it->second;
+
+    // Every node on the path is a (non-strict) parent domain of |host|.
+    const Node& current = nodes_[node];
+    values->insert(values->end(), current.subdomain_values.begin(),
+                   current.subdomain_values.end());
+    if (dot == std::string::npos) {
+      values->insert(values->end(), current.exact_values.begin(),
+                     current.exact_values.end());
+      return;
+    }
+    end = dot;
+  }
+}
+
 struct ManagedModeURLFilter::Contents {
+  // Whitelist patterns that only restrict the hostname, mapped to site IDs.
+  HostTrie host_trie;
+  // All other whitelist patterns.
   URLMatcher url_matcher;
   std::map<URLMatcherConditionSet::ID, int> matcher_site_map;
   base::hash_multimap<std::string, int> hash_site_map;
@@ -48,6 +147,21 @@ const char* kFilteredSchemes[] = {
   "wss"
 };
 
+// Returns true if |host| is made up of lower-case ASCII letters, digits,
+// hyphens and dots, i.e. if it is already in the form GURL canonicalizes
+// hostnames to and can be matched against URL hosts label by label.
+bool IsIndexableHost(const std::string& host) {
+  if (host.empty() || host[0] == '.' || host[host.length() - 1] == '.')
+    return false;
+  for (size_t i = 0; i < host.length(); ++i) {
+    char c = host[i];
+    if (!(c >= 'a' && c <= 'z') && !(c >= '0' && c <= '9') && c != '-' &&
+        c != '.') {
+      return false;
+    }
+  }
+  return true;
+}
 
 // This class encapsulates all the state that is required during construction of
 // a new ManagedModeURLFilter::Contents.
@@ -100,6 +214,14 @@ bool FilterBuilder::AddPattern(const std::string& pattern, int site_id) {
     return false;
   }
 
+  // Most patterns are just a hostname. Those are kept in the host trie, which
+  // is much cheaper to query than the URLMatcher.
+  if (scheme.empty() && port == 0 && (path.empty() || path == "/") &&
+      query.empty() && IsIndexableHost(host)) {
+    contents_->host_trie.Add(host, match_subdomains, site_id);
+    return true;
+  }
+
   scoped_refptr<URLMatcherConditionSet> condition_set =
       URLBlacklist::CreateConditionSet(
           &contents_->url_matcher, ++matcher_id_,
@@ -176,7 +298,9 @@ scoped_ptr<ManagedModeURLFilter::Contents> LoadWhitelistsOnBlockingPoolThread(
 
 ManagedModeURLFilter::ManagedModeURLFilter()
     : default_behavior_(ALLOW),
-      contents_(new Contents()) {
+      contents_(new Contents()),
+      manual_host_trie_(new HostTrie()),
+      manual_host_any_registry_trie_(new HostTrie()) {
   // Detach from the current thread so we can be constructed on a different
   // thread than the one where we're used.
   DetachFromThread();
@@ -279,27 +403,33 @@ ManagedModeURLFilter::GetFilteringBehaviorForURL(const GURL& url) const {
 
   // Look for patterns matching the hostname, with a value that is different
   // from the default (a value of true in the map meaning allowed).
-  for (std::map<std::string, bool>::const_iterator host_it =
-      host_map_.begin(); host_it != host_map_.end(); ++host_it) {
-    if ((host_it->second == (default_behavior_ == BLOCK)) &&
-        HostMatchesPattern(host, host_it->first)) {
-      return host_it->second ? ALLOW : BLOCK;
-    }
-  }
+  bool allow = default_behavior_ == BLOCK;
+  if (MatchesManualHostPattern(host, allow))
+    return allow ? ALLOW : BLOCK;
 
   // If the default behavior is to allow, we don't need to check anything else.
   if (default_behavior_ == ALLOW)
     return ALLOW;
 
-  // Check the list of URL patterns.
-  std::set<URLMatcherConditionSet::ID> matching_ids =
-      contents_->url_matcher.MatchURL(url);
-  if (!matching_ids.empty())
+  // Check the hostname-only whitelist patterns.
+  std::vector<int> site_ids;
+  contents_->host_trie.GetMatches(host, &site_ids);
+  if (!site_ids.empty())
     return ALLOW;
 
+  // Check the remaining URL patterns.
+  if (!contents_->matcher_site_map.empty()) {
+    std::set<URLMatcherConditionSet::ID> matching_ids =
+        contents_->url_matcher.MatchURL(url);
+    if (!matching_ids.empty())
+      return ALLOW;
+  }
+
   // Check the list of hostname hashes.
-  if (contents_->hash_site_map.count(GetHostnameHash(url)))
+  if (!contents_->hash_site_map.empty() &&
+      contents_->hash_site_map.count(GetHostnameHash(url))) {
     return ALLOW;
+  }
 
   // Fall back to the default behavior.
   return default_behavior_;
@@ -308,6 +438,15 @@ ManagedModeURLFilter::GetFilteringBehaviorForURL(const GURL& url) const {
 void ManagedModeURLFilter::GetSites(
     const GURL& url,
     std::vector<ManagedModeSiteList::Site*>* sites) const {
+  std::vector<int> site_ids;
+  contents_->host_trie.GetMatches(url.host(), &site_ids);
+  for (std::vector<int>::const_iterator it = site_ids.begin();
+       it != site_ids.end(); ++it) {
+    // Patterns set through SetFromPatterns() don't belong to a site.
+    if (*it >= 0)
+      sites->push_back(&contents_->sites[*it]);
+  }
+
   std::set<URLMatcherConditionSet::ID> matching_ids =
       contents_->url_matcher.MatchURL(url);
   for (std::set<URLMatcherConditionSet::ID>::const_iterator it =
@@ -364,6 +503,27 @@ void ManagedModeURLFilter::SetManualHosts(
     const std::map<std::string, bool>* host_map) {
   DCHECK(CalledOnValidThread());
   host_map_ = *host_map;
+
+  manual_host_trie_.reset(new HostTrie());
+  manual_host_any_registry_trie_.reset(new HostTrie());
+  for (std::map<std::string, bool>::const_iterator it = host_map_.begin();
+       it != host_map_.end(); ++it) {
+    // See HostMatchesPattern() for the pattern syntax.
+    std::string pattern = it->first;
+    HostTrie* trie = manual_host_trie_.get();
+    if (EndsWith(pattern, ".*", true)) {
+      pattern.erase(pattern.length() - 2);
+      trie = manual_host_any_registry_trie_.get();
+    }
+    bool match_subdomains = StartsWithASCII(pattern, "*.", true);
+    if (match_subdomains) {
+      pattern.erase(0, 2);
+      if (pattern.empty() || pattern.find('*') != std::string::npos)
+        continue;
+    }
+    trie->Add(pattern, match_subdomains, it->second ? 1 : 0);
+  }
+
   UMA_HISTOGRAM_CUSTOM_COUNTS("ManagedMode.ManualHostsEntries",
                               host_map->size(), 1, 1000, 50);
 }
@@ -384,6 +544,23 @@ void ManagedModeURLFilter::RemoveObserver(Observer* observer) {
   observers_.RemoveObserver(observer);
 }
 
+bool ManagedModeURLFilter::MatchesManualHostPattern(const std::string& host,
+                                                    bool allow) const {
+  std::vector<int> values;
+  manual_host_trie_->GetMatches(host, &values);
+  if (!manual_host_any_registry_trie_->empty()) {
+    size_t registry_length = GetRegistryLength(
+        host, EXCLUDE_UNKNOWN_REGISTRIES, EXCLUDE_PRIVATE_REGISTRIES);
+    // A host without a known registry part does not match.
+    if (registry_length > 0 && registry_length < host.length()) {
+      manual_host_any_registry_trie_->GetMatches(
+          host.substr(0, host.length() - (registry_length + 1)), &values);
+    }
+  }
+  return std::find(values.begin(), values.end(), allow ? 1 : 0) !=
+         values.end();
+}
+
 void ManagedModeURLFilter::SetContents(scoped_ptr<Contents> contents) {
   DCHECK(CalledOnValidThread());
   contents_ = contents.Pass();
@@ -104,8 +104,13 @@ class ManagedModeURLFilter
 
  private:
   friend class base::RefCountedThreadSafe<ManagedModeURLFilter>;
+  class HostTrie;
   ~ManagedModeURLFilter();
 
+  // Returns true if one of the wildcard patterns in |host_map_| with the given
+  // |allow| value matches |host|.
+  bool MatchesManualHostPattern(const std::string& host, bool allow) const;
+
   void SetContents(scoped_ptr<Contents> url_matcher);
 
   ObserverList<Observer> observers_;
@@ -121,6 +126,13 @@ class ManagedModeURLFilter
   // (false).
   std::map<std::string, bool> host_map_;
 
+  // The patterns in |host_map_|, indexed by their reversed labels so that a
+  // host can be checked against all of them at once. Patterns ending in ".*"
+  // are kept in |manual_host_any_registry_trie_| without that suffix, and are
+  // matched against the host with its registry stripped.
+  scoped_ptr<HostTrie> manual_host_trie_;
+  scoped_ptr<HostTrie> manual_host_any_registry_trie_;
+
   DISALLOW_COPY_AND_ASSIGN(ManagedModeURLFilter);
 };
 
@@ -6,8 +6,11 @@
 #include "base/bind_helpers.h"
 #include "base/message_loop/message_loop.h"
 #include "base/run_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
 #include "chrome/browser/managed_mode/managed_mode_url_filter.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
 #include "url/gurl.h"
 
 class ManagedModeURLFilterTest : public ::testing::Test,
@@ -139,6 +142,28 @@ TEST_F(ManagedModeURLFilterTest, Host) {
   EXPECT_FALSE(IsURLWhitelisted("http://subdomain.example.com"));
 }
 
+TEST_F(ManagedModeURLFilterTest, HostAndPathPatterns) {
+  std::vector<std::string> list;
+  // Hostname-only patterns and patterns with a path can be mixed.
+  list.push_back("example.com");
+  list.push_back(".exact.example.org");
+  list.push_back("path.example.net/allowed");
+  list.push_back("example.co.uk/");
+  filter_->SetFromPatterns(list);
+  run_loop_.Run();
+
+  EXPECT_TRUE(IsURLWhitelisted("http://example.com/"));
+  EXPECT_TRUE(IsURLWhitelisted("http://a.b.example.com/c"));
+  EXPECT_FALSE(IsURLWhitelisted("http://example.com.evil.com/"));
+  EXPECT_FALSE(IsURLWhitelisted("http://notexample.com/"));
+  EXPECT_TRUE(IsURLWhitelisted("http://exact.example.org/"));
+  EXPECT_FALSE(IsURLWhitelisted("http://sub.exact.example.org/"));
+  EXPECT_FALSE(IsURLWhitelisted("http://example.org/"));
+  EXPECT_TRUE(IsURLWhitelisted("http://path.example.net/allowed/page"));
+  EXPECT_FALSE(IsURLWhitelisted("http://path.example.net/other"));
+  EXPECT_TRUE(IsURLWhitelisted("https://www.example.co.uk/anything"));
+}
+
 TEST_F(ManagedModeURLFilterTest, IPAddress) {
   std::vector<std::string> list;
   // Filter an ip address.
@@ -334,3 +359,72 @@ TEST_F(ManagedModeURLFilterTest, Patterns) {
   EXPECT_FALSE(IsURLWhitelisted("http://www.google.co.uk/blurp/"));
   EXPECT_TRUE(IsURLWhitelisted("http://mail.google.com/moose/"));
 }
+
+TEST_F(ManagedModeURLFilterTest, ManualHostPatternsWithSameSuffix) {
+  std::map<std::string, bool> hosts;
+  hosts["*.example.com"] = true;
+  hosts["*.b.example.com"] = false;
+  hosts["*.example.*"] = true;
+  hosts["*."] = true;
+  hosts["*.*.example.com"] = true;
+  filter_->SetManualHosts(&hosts);
+
+  // Only patterns with a value different from the default are considered, so
+  // the blocking pattern for b.example.com doesn't apply.
+  EXPECT_TRUE(IsURLWhitelisted("http://example.com/"));
+  EXPECT_TRUE(IsURLWhitelisted("http://a.b.example.com/"));
+  EXPECT_TRUE(IsURLWhitelisted("http://www.example.co.uk/"));
+  EXPECT_FALSE(IsURLWhitelisted("http://example/"));
+  EXPECT_FALSE(IsURLWhitelisted("http://www.google.com/"));
+
+  filter_->SetDefaultFilteringBehavior(ManagedModeURLFilter::ALLOW);
+  EXPECT_TRUE(IsURLWhitelisted("http://example.com/"));
+  EXPECT_FALSE(IsURLWhitelisted("http://b.example.com/"));
+  EXPECT_FALSE(IsURLWhitelisted("http://a.b.example.com/"));
+}
+
+// Measures lookups against a whitelist and manual host list with tens of
+// thousands of entries, as loaded from large content packs. This is manual as
+// it only reports timings; the tests above cover the matching.
+TEST_F(ManagedModeURLFilterTest, MANUAL_LargeWhitelistLookupTime) {
+  const int kWhitelistEntries = 50000;
+  const int kManualHostEntries = 10000;
+  const int kLookups = 10000;
+
+  std::vector<std::string> list;
+  for (int i = 0; i < kWhitelistEntries; ++i)
+    list.push_back(base::StringPrintf("site%d.example%d.com", i, i % 100));
+  std::map<std::string, bool> hosts;
+  for (int i = 0; i < kManualHostEntries; ++i)
+    hosts[base::StringPrintf("*.manual%d.example.org", i)] = true;
+  filter_->SetManualHosts(&hosts);
+  filter_->SetFromPatterns(list);
+  run_loop_.Run();
+
+  int allowed = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kLookups; ++i) {
+    // Alternate between whitelisted, manually allowed and unknown hosts.
+    std::string url;
+    switch (i % 3) {
+      case 0:
+        url = base::StringPrintf("http://www.site%d.example%d.com/page",
+                                 i, i % 100);
+        break;
+      case 1:
+        url = base::StringPrintf("http://www.manual%d.example.org/", i);
+        break;
+      default:
+        url = base::StringPrintf("http://unknown%d.example.net/", i);
+        break;
+    }
+    if (IsURLWhitelisted(url))
+      ++allowed;
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+  EXPECT_EQ(kLookups - kLookups / 3, allowed);
+  perf_test::PrintResult(
+      "managed_mode_url_filter", "", "lookup_time",
+      elapsed.InMicroseconds() / static_cast<double>(kLookups), "us", true);
+}
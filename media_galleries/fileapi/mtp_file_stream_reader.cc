@@ -158,6 +158,17 @@ void MTPFileStreamReader::FinishValidateMediaHeader(
   if (header_buf == buf)
     return FinishRead(callback, file_info, header_bytes_read);
 
+  // If the header bytes already cover the start of the requested range, serve
+  // what they hold as a short read instead of another device transaction.
+  if (buf_len > 0 && current_offset_ < header_bytes_read) {
+    int header_offset = base::checked_cast<int>(current_offset_);
+    int bytes_to_copy = std::min(buf_len, header_bytes_read - header_offset);
+    std::copy(header_buf->data() + header_offset,
+              header_buf->data() + header_offset + bytes_to_copy,
+              buf->data());
+    return FinishRead(callback, file_info, bytes_to_copy);
+  }
+
   // Header buffer isn't the same as the original read buffer. Make a separate
   // request for that.
   ReadBytes(url_, buf, current_offset_, buf_len,
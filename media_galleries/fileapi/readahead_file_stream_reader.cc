@@ -16,7 +16,13 @@ using webkit_blob::FileStreamReader;
 namespace {
 
 const size_t kDesiredNumberOfBuffers = 2;  // So we are always one buffer ahead.
-const int kBufferSize = 1024*1024;  // 1MB to minimize transaction costs.
+
+// The source is first read in small chunks, so that callers which only look at
+// the start of a file (e.g. to sniff its type) don't wait on a large transfer.
+// Each buffer the caller drains doubles the chunk size, up to a 4MB limit, to
+// minimize transaction costs for long sequential reads.
+const int kInitialBufferSize = 64*1024;
+const int kMaxBufferSize = 4*1024*1024;
 
 }  // namespace
 
@@ -24,6 +30,7 @@ ReadaheadFileStreamReader::ReadaheadFileStreamReader(FileStreamReader* source)
     : source_(source),
       source_error_(0),
       source_has_pending_read_(false),
+      buffer_size_(kInitialBufferSize),
       weak_factory_(this) {
 }
 
@@ -85,6 +92,9 @@ int ReadaheadFileStreamReader::FinishReadFromCacheOrStoredError(
     if (source_buffer->BytesRemaining() == 0) {
       buffers_.pop();
 
+      // The caller is streaming through the file, so fetch more at once.
+      buffer_size_ = std::min(buffer_size_ * 2, kMaxBufferSize);
+
       // Get a new buffer to replace the one we just used up.
       ReadFromSourceIfNeeded();
     }
@@ -101,10 +111,10 @@ void ReadaheadFileStreamReader::ReadFromSourceIfNeeded() {
 
   source_has_pending_read_ = true;
 
-  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(kBufferSize));
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(buffer_size_));
   int result = source_->Read(
       buf,
-      kBufferSize,
+      buffer_size_,
       base::Bind(&ReadaheadFileStreamReader::OnFinishReadFromSource,
                  weak_factory_.GetWeakPtr(), buf));
 
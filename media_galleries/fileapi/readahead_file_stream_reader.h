@@ -45,6 +45,10 @@ class ReadaheadFileStreamReader
   int source_error_;
   bool source_has_pending_read_;
 
+  // The size of the next read from |source_|. This grows as the caller
+  // consumes buffers.
+  int buffer_size_;
+
   // This contains a queue of buffers filled from |source_|, waiting to be
   // consumed.
   std::queue<scoped_refptr<net::DrainableIOBuffer> > buffers_;
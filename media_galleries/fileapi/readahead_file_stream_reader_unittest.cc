@@ -0,0 +1,152 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/media_galleries/fileapi/readahead_file_stream_reader.h"
+
+#include <algorithm>
+#include <string>
+
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
+#include "base/time/time.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace {
+
+// Simulated cost of one MTP ReadBytes round trip, and of moving the bytes.
+const int64 kTransactionLatencyMs = 20;
+const int64 kBytesPerMs = 20 * 1024;
+
+struct TransferStats {
+  TransferStats() : transactions(0), largest_transfer(0) {}
+
+  int transactions;
+  int largest_transfer;
+  base::TimeDelta simulated_time;
+};
+
+// Stands in for MTPFileStreamReader: every Read() is one device transaction,
+// completed asynchronously.
+class FakeMTPFileStreamReader : public webkit_blob::FileStreamReader {
+ public:
+  FakeMTPFileStreamReader(const std::string& data, TransferStats* stats)
+      : data_(data),
+        offset_(0),
+        stats_(stats) {
+  }
+  virtual ~FakeMTPFileStreamReader() {}
+
+  virtual int Read(net::IOBuffer* buf, int buf_len,
+                   const net::CompletionCallback& callback) OVERRIDE {
+    int bytes_read =
+        std::min(buf_len, static_cast<int>(data_.size() - offset_));
+    std::copy(data_.data() + offset_, data_.data() + offset_ + bytes_read,
+              buf->data());
+    offset_ += bytes_read;
+
+    stats_->transactions++;
+    stats_->largest_transfer = std::max(stats_->largest_transfer, buf_len);
+    stats_->simulated_time += base::TimeDelta::FromMilliseconds(
+        kTransactionLatencyMs + bytes_read / kBytesPerMs);
+
+    base::MessageLoop::current()->PostTask(FROM_HERE,
+                                           base::Bind(callback, bytes_read));
+    return net::ERR_IO_PENDING;
+  }
+
+  virtual int64 GetLength(
+      const net::Int64CompletionCallback& callback) OVERRIDE {
+    return data_.size();
+  }
+
+ private:
+  const std::string data_;
+  size_t offset_;
+  TransferStats* stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(FakeMTPFileStreamReader);
+};
+
+class ReadaheadFileStreamReaderTest : public testing::Test {
+ protected:
+  std::string MakeData(size_t size) {
+    std::string data(size, '\0');
+    for (size_t i = 0; i < size; ++i)
+      data[i] = static_cast<char>(i * 31);
+    return data;
+  }
+
+  // Reads |reader| to EOF in |chunk_size| pieces.
+  std::string ReadAll(webkit_blob::FileStreamReader* reader, int chunk_size) {
+    std::string result;
+    scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(chunk_size));
+    while (true) {
+      net::TestCompletionCallback callback;
+      int rv = callback.GetResult(
+          reader->Read(buf.get(), chunk_size, callback.callback()));
+      EXPECT_GE(rv, 0);
+      if (rv <= 0)
+        break;
+      result.append(buf->data(), rv);
+    }
+    return result;
+  }
+
+ private:
+  base::MessageLoop message_loop_;
+};
+
+TEST_F(ReadaheadFileStreamReaderTest, ReadsWholeFile) {
+  const std::string data = MakeData(3 * 1024 * 1024 + 17);
+  TransferStats stats;
+  ReadaheadFileStreamReader reader(new FakeMTPFileStreamReader(data, &stats));
+
+  EXPECT_EQ(data, ReadAll(&reader, 32 * 1024));
+  // The read-ahead window grew past its initial size, so the file took fewer
+  // transactions than 64KB reads would have.
+  EXPECT_GT(stats.largest_transfer, 64 * 1024);
+  EXPECT_LE(stats.largest_transfer, 4 * 1024 * 1024);
+  EXPECT_LT(stats.transactions, static_cast<int>(data.size() / (64 * 1024)));
+}
+
+TEST_F(ReadaheadFileStreamReaderTest, ShortReadKeepsWindowSmall) {
+  const std::string data = MakeData(8 * 1024 * 1024);
+  TransferStats stats;
+  ReadaheadFileStreamReader reader(new FakeMTPFileStreamReader(data, &stats));
+
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(512));
+  net::TestCompletionCallback callback;
+  EXPECT_EQ(512, callback.GetResult(
+      reader.Read(buf.get(), 512, callback.callback())));
+  EXPECT_EQ(data.substr(0, 512), std::string(buf->data(), 512));
+  base::MessageLoop::current()->RunUntilIdle();
+
+  // Sniffing the header only fetched the initial window, plus one more
+  // buffer of read-ahead.
+  EXPECT_EQ(64 * 1024, stats.largest_transfer);
+  EXPECT_LE(stats.transactions, 2);
+}
+
+// Reports the device transactions and simulated transfer time of importing a
+// 32MB file. This is manual as it only reports numbers; ReadsWholeFile covers
+// the read-ahead behavior.
+TEST_F(ReadaheadFileStreamReaderTest, MANUAL_SequentialImportPerf) {
+  const std::string data = MakeData(32 * 1024 * 1024);
+  TransferStats stats;
+  ReadaheadFileStreamReader reader(new FakeMTPFileStreamReader(data, &stats));
+
+  EXPECT_EQ(data.size(), ReadAll(&reader, 32 * 1024).size());
+  perf_test::PrintResult("mtp_readahead", "", "transactions",
+                         static_cast<double>(stats.transactions), "count",
+                         true);
+  perf_test::PrintResult(
+      "mtp_readahead", "", "simulated_transfer_time",
+      static_cast<double>(stats.simulated_time.InMilliseconds()), "ms", true);
+}
+
+}  // namespace
@@ -7,10 +7,12 @@
 #include "base/bind.h"
 #include "base/debug/trace_event.h"
 #include "base/file_util.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/numerics/safe_conversions.h"
 #include "base/path_service.h"
 #include "base/rand_util.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
 #include "base/time/time.h"
 #include "chrome/browser/component_updater/component_updater_service.h"
 #include "chrome/browser/profiles/profile.h"
@@ -23,6 +25,18 @@
 using component_updater::ComponentUpdateService;
 using content::BrowserThread;
 
+namespace {
+
+// Returns the contents of |map| as a StringPiece. The CRLSet parsers only need
+// a read-only view of the bytes, so parsing straight out of the mapping avoids
+// copying the whole file onto the heap first.
+base::StringPiece MappedFileAsStringPiece(const base::MemoryMappedFile& map) {
+  return base::StringPiece(reinterpret_cast<const char*>(map.data()),
+                           map.length());
+}
+
+}  // namespace
+
 CRLSetFetcher::CRLSetFetcher() : cus_(NULL) {}
 
 bool CRLSetFetcher::GetCRLSetFilePath(base::FilePath* path) const {
@@ -78,13 +92,14 @@ void CRLSetFetcher::LoadFromDisk(base::FilePath path,
 
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
 
-  std::string crl_set_bytes;
+  base::MemoryMappedFile crl_set_file;
   {
-    TRACE_EVENT0("CRLSetFetcher", "ReadFileToString");
-    if (!base::ReadFileToString(path, &crl_set_bytes))
+    TRACE_EVENT0("CRLSetFetcher", "MapFile");
+    if (!crl_set_file.Initialize(path))
       return;
   }
 
+  const base::StringPiece crl_set_bytes = MappedFileAsStringPiece(crl_set_file);
   if (!net::CRLSet::Parse(crl_set_bytes, out_crl_set)) {
     LOG(WARNING) << "Failed to parse CRL set from " << path.MaybeAsASCII();
     return;
@@ -104,7 +119,12 @@ void CRLSetFetcher::SetCRLSetIfNewer(
     scoped_refptr<net::CRLSet> crl_set) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
 
+  // SSLConfigService hands out references to the current CRLSet, so
+  // verifications that are already in flight keep using the set they started
+  // with while new ones pick up |crl_set|.
   scoped_refptr<net::CRLSet> old_crl_set(net::SSLConfigService::GetCRLSet());
+  if (old_crl_set.get() == crl_set.get())
+    return;
   if (old_crl_set.get() && old_crl_set->sequence() > crl_set->sequence()) {
     LOG(WARNING) << "Refusing to downgrade CRL set from #"
                  << old_crl_set->sequence()
@@ -159,11 +179,12 @@ bool CRLSetFetcher::Install(const base::DictionaryValue& manifest,
   if (!GetCRLSetFilePath(&save_to))
     return true;
 
-  std::string crl_set_bytes;
-  if (!base::ReadFileToString(crl_set_file_path, &crl_set_bytes)) {
+  base::MemoryMappedFile crl_set_file;
+  if (!crl_set_file.Initialize(crl_set_file_path)) {
     LOG(WARNING) << "Failed to find crl-set file inside CRX";
     return false;
   }
+  const base::StringPiece crl_set_bytes = MappedFileAsStringPiece(crl_set_file);
 
   bool is_delta;
   if (!net::CRLSet::GetIsDeltaUpdate(crl_set_bytes, &is_delta)) {
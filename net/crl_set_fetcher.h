@@ -49,7 +49,8 @@ class CRLSetFetcher : public component_updater::ComponentInstaller,
   void DoInitialLoadFromDisk();
 
   // LoadFromDisk runs on the FILE thread and attempts to load a CRL set
-  // from |load_from|.
+  // from |load_from|. The file is memory-mapped and parsed in place rather
+  // than being read into a temporary string.
   void LoadFromDisk(base::FilePath load_from,
                     scoped_refptr<net::CRLSet>* out_crl_set);
 
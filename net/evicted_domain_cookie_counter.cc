@@ -4,12 +4,8 @@
 
 #include "chrome/browser/net/evicted_domain_cookie_counter.h"
 
-#include <algorithm>
-#include <vector>
-
+#include "base/hash.h"
 #include "base/metrics/histogram.h"
-#include "base/stl_util.h"
-#include "base/strings/string_util.h"
 #include "chrome/browser/google/google_util.h"
 #include "net/cookies/canonical_cookie.h"
 
@@ -85,10 +81,7 @@ EvictedDomainCookieCounter::EvictedDomainCookieCounter(
   DCHECK_LT(purge_count, max_size_);
 }
 
-EvictedDomainCookieCounter::~EvictedDomainCookieCounter() {
-  STLDeleteContainerPairSecondPointers(evicted_cookies_.begin(),
-                                       evicted_cookies_.end());
-}
+EvictedDomainCookieCounter::~EvictedDomainCookieCounter() {}
 
 size_t EvictedDomainCookieCounter::GetStorageSize() const {
   return evicted_cookies_.size();
@@ -119,15 +112,18 @@ void EvictedDomainCookieCounter::OnLoaded() {
 // static
 EvictedDomainCookieCounter::EvictedCookieKey
     EvictedDomainCookieCounter::GetKey(const net::CanonicalCookie& cookie) {
-  return cookie.Domain() + ";" + cookie.Path() + ";" + cookie.Name();
+  uint64 domain_hash = base::Hash(cookie.Domain());
+  uint32 path_name_hash =
+      base::Hash(cookie.Path()) * 31 + base::Hash(cookie.Name());
+  return (domain_hash << 32) | path_name_hash;
 }
 
-// static
-bool EvictedDomainCookieCounter::CompareEvictedCookie(
-    const EvictedCookieMap::iterator evicted_cookie1,
-    const EvictedCookieMap::iterator evicted_cookie2) {
-  return evicted_cookie1->second->eviction_time
-      < evicted_cookie2->second->eviction_time;
+void EvictedDomainCookieCounter::RemoveEvictedCookie(
+    EvictionList::iterator it) {
+  if (it->expiry_it != expiry_map_.end())
+    expiry_map_.erase(it->expiry_it);
+  evicted_cookies_.erase(it->key);
+  eviction_list_.erase(it);
 }
 
 void EvictedDomainCookieCounter::GarbageCollect(const Time& current_time) {
@@ -137,56 +133,44 @@ void EvictedDomainCookieCounter::GarbageCollect(const Time& current_time) {
   // From |evicted_cookies_|, removed all expired cookies, and remove cookies
   // with the oldest |eviction_time| so that |size_goal| is attained.
   size_t size_goal = max_size_ - purge_count_;
-  // Bound on number of non-expired cookies to remove.
-  size_t remove_quota = evicted_cookies_.size() - size_goal;
-  DCHECK_GT(remove_quota, 0u);
-
-  std::vector<EvictedCookieMap::iterator> remove_list;
-  remove_list.reserve(evicted_cookies_.size());
-
-  EvictedCookieMap::iterator it = evicted_cookies_.begin();
-  while (it != evicted_cookies_.end()) {
-    if (it->second->is_expired(current_time)) {
-      delete it->second;
-      evicted_cookies_.erase(it++); // Post-increment idiom for in-loop removal.
-      if (remove_quota)
-        --remove_quota;
-    } else {
-      if (remove_quota)  // Don't bother storing if quota met.
-        remove_list.push_back(it);
-      ++it;
-    }
-  }
 
-  // Free the oldest |remove_quota| non-expired cookies.
-  std::partial_sort(remove_list.begin(), remove_list.begin() + remove_quota,
-                    remove_list.end(), CompareEvictedCookie);
-  for (size_t i = 0; i < remove_quota; ++i) {
-    delete remove_list[i]->second;
-    evicted_cookies_.erase(remove_list[i]);
+  // Expired cookies are at the front of |expiry_map_|.
+  while (!expiry_map_.empty() &&
+         expiry_map_.begin()->first <= current_time) {
+    EvictedCookieMap::iterator it =
+        evicted_cookies_.find(expiry_map_.begin()->second);
+    DCHECK(it != evicted_cookies_.end());
+    RemoveEvictedCookie(it->second);
   }
 
-  // Apply stricter check if non-expired cookies were deleted.
-  DCHECK(remove_quota ? evicted_cookies_.size() == size_goal :
-         evicted_cookies_.size() <= size_goal);
+  // The oldest evictions are at the front of |eviction_list_|.
+  while (evicted_cookies_.size() > size_goal)
+    RemoveEvictedCookie(eviction_list_.begin());
+
+  DCHECK_EQ(evicted_cookies_.size(), eviction_list_.size());
+  DCHECK_LE(evicted_cookies_.size(), size_goal);
 }
 
 void EvictedDomainCookieCounter::StoreEvictedCookie(
     const EvictedCookieKey& key,
     const net::CanonicalCookie& cookie,
     const Time& current_time) {
+  // A key that is already present belongs to a cookie whose key collides with
+  // this one; the newer eviction replaces it.
+  EvictedCookieMap::iterator prev_entry = evicted_cookies_.find(key);
+  if (prev_entry != evicted_cookies_.end())
+    RemoveEvictedCookie(prev_entry->second);
+
   bool is_google = google_util::IsGoogleHostname(
       cookie.Domain(), google_util::ALLOW_SUBDOMAIN);
-  EvictedCookie* evicted_cookie =
-      new EvictedCookie(current_time, cookie.ExpiryDate(), is_google);
-  std::pair<EvictedCookieMap::iterator, bool> prev_entry =
-      evicted_cookies_.insert(
-          EvictedCookieMap::value_type(key, evicted_cookie));
-  if (!prev_entry.second) {
-    NOTREACHED();
-    delete prev_entry.first->second;
-    prev_entry.first->second = evicted_cookie;
+  EvictedCookie evicted_cookie(current_time, cookie.ExpiryDate(), is_google);
+  ExpiryMap::iterator expiry_it = expiry_map_.end();
+  if (!evicted_cookie.expiry_time.is_null()) {
+    expiry_it = expiry_map_.insert(
+        ExpiryMap::value_type(evicted_cookie.expiry_time, key));
   }
+  eviction_list_.push_back(EvictedCookieEntry(key, evicted_cookie, expiry_it));
+  evicted_cookies_[key] = --eviction_list_.end();
 
   GarbageCollect(current_time);
 }
@@ -197,10 +181,10 @@ void EvictedDomainCookieCounter::ProcessNewCookie(
     const Time& current_time) {
   EvictedCookieMap::iterator it = evicted_cookies_.find(key);
   if (it != evicted_cookies_.end()) {
-    if (!it->second->is_expired(current_time))  // Reinstatement.
-      cookie_counter_delegate_->Report(*it->second, current_time);
-    delete it->second;
-    evicted_cookies_.erase(it);
+    const EvictedCookie& evicted_cookie = it->second->cookie;
+    if (!evicted_cookie.is_expired(current_time))  // Reinstatement.
+      cookie_counter_delegate_->Report(evicted_cookie, current_time);
+    RemoveEvictedCookie(it->second);
   }
 }
 
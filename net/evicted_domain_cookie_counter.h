@@ -5,11 +5,12 @@
 #ifndef CHROME_BROWSER_NET_EVICTED_DOMAIN_COOKIE_COUNTER_H_
 #define CHROME_BROWSER_NET_EVICTED_DOMAIN_COOKIE_COUNTER_H_
 
+#include <list>
 #include <map>
-#include <string>
 
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "base/containers/hash_tables.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/time/time.h"
@@ -40,6 +41,11 @@ namespace chrome_browser_net {
 //
 // Metrics for Google domains are tracked separately.
 //
+// Evicted cookies are identified by a fixed-size hash of (domain, path, name)
+// and kept in eviction order, so storing, reinstating and purging an entry
+// never has to scan the whole storage. The number of stored entries is capped,
+// which bounds the memory used by the counter.
+//
 class EvictedDomainCookieCounter : public net::CookieMonster::Delegate {
  public:
   // Structure to store sanitized data from CanonicalCookie.
@@ -93,11 +99,35 @@ class EvictedDomainCookieCounter : public net::CookieMonster::Delegate {
   virtual void OnLoaded() OVERRIDE;
 
  private:
-  // Identifier of an evicted cookie.
-  typedef std::string EvictedCookieKey;
+  // Identifier of an evicted cookie: a hash of its domain, path and name.
+  // Collisions are harmless beyond a spurious reinstatement report; a
+  // colliding eviction replaces the entry already stored under its key.
+  typedef uint64 EvictedCookieKey;
+
+  // Evicted cookies that expire, ordered by expiry time.
+  typedef std::multimap<base::Time, EvictedCookieKey> ExpiryMap;
+
+  struct EvictedCookieEntry {
+    EvictedCookieEntry(EvictedCookieKey key_in,
+                       const EvictedCookie& cookie_in,
+                       ExpiryMap::iterator expiry_it_in)
+        : key(key_in),
+          cookie(cookie_in),
+          expiry_it(expiry_it_in) {}
+
+    EvictedCookieKey key;
+    EvictedCookie cookie;
+    // Position in |expiry_map_|, or |expiry_map_.end()| for cookies that do
+    // not expire.
+    ExpiryMap::iterator expiry_it;
+  };
+
+  // Evicted cookies in the order they were evicted, oldest first.
+  typedef std::list<EvictedCookieEntry> EvictionList;
 
-  // Storage class of evicted cookie.
-  typedef std::map<EvictedCookieKey, EvictedCookie*> EvictedCookieMap;
+  // Lookup from key into |eviction_list_|.
+  typedef base::hash_map<EvictedCookieKey, EvictionList::iterator>
+      EvictedCookieMap;
 
   virtual ~EvictedDomainCookieCounter();
 
@@ -105,10 +135,8 @@ class EvictedDomainCookieCounter : public net::CookieMonster::Delegate {
   // i.e., IsEquivalent(a, b) ==> GetKey(a) == GetKey(b).
   static EvictedCookieKey GetKey(const net::CanonicalCookie& cookie);
 
-  // Comparator for sorting, to make recently evicted cookies appear earlier.
-  static bool CompareEvictedCookie(
-      const EvictedCookieMap::iterator evicted_cookie1,
-      const EvictedCookieMap::iterator evicted_cookie2);
+  // Removes the entry at |it| from all storage structures.
+  void RemoveEvictedCookie(EvictionList::iterator it);
 
   // If too many evicted cookies are stored, delete the expired ones, then
   // delete cookies that were evicted the longest, until size limit reached.
@@ -131,7 +159,9 @@ class EvictedDomainCookieCounter : public net::CookieMonster::Delegate {
 
   scoped_ptr<Delegate> cookie_counter_delegate_;
 
+  EvictionList eviction_list_;
   EvictedCookieMap evicted_cookies_;
+  ExpiryMap expiry_map_;
 
   // Capacity of the evicted cookie storage, before garbage collection occurs.
   const size_t max_size_;
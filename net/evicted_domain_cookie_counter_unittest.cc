@@ -386,6 +386,23 @@ TEST_F(EvictedDomainCookieCounterTest, TestGarbageCollectionWithExpiry) {
   EXPECT_EQ("1499,1497;300", google_stat_ + ";" + other_stat_);
 }
 
+// Storage never exceeds its capacity, regardless of how many distinct cookies
+// are evicted, and the most recently evicted cookies are the ones retained.
+TEST_F(EvictedDomainCookieCounterTest, TestStorageBounded) {
+  InitCounter(50, 10);
+  for (int i = 0; i < 1000; ++i) {
+    StepTime(1);
+    CreateNewCookie(other_url1, "a" + base::IntToString(i) + "=1", 0);
+    Evict(cookies_[i]);
+    EXPECT_GE(50u, cookie_counter_->GetStorageSize());
+  }
+  // Only the latest evictions are reinstated.
+  StepTime(1);
+  Add(cookies_[0]);
+  Add(cookies_[999]);
+  EXPECT_EQ(";1", google_stat_ + ";" + other_stat_);
+}
+
 }  // namespace
 
 }  // namespace chrome_browser_net
@@ -209,6 +209,18 @@ bool PrintJob::FlushJob(base::TimeDelta timeout) {
   return true;
 }
 
+void PrintJob::OnNewPageAvailable() {
+  DCHECK_EQ(ui_message_loop_, base::MessageLoop::current());
+  if (!is_job_pending_ || !worker_.get() || !worker_->message_loop())
+    return;
+
+  worker_->message_loop()->PostTask(
+      FROM_HERE,
+      base::Bind(&HoldRefCallback, make_scoped_refptr(this),
+                 base::Bind(&PrintJobWorker::OnNewPage,
+                            base::Unretained(worker_.get()))));
+}
+
 void PrintJob::DisconnectSource() {
   source_ = NULL;
   if (document_.get())
@@ -65,6 +65,10 @@ class PrintJob : public PrintJobWorkerOwner,
   // spool as soon as data is available.
   void StartPrinting();
 
+  // Called when a page has been added to the document, so the worker can
+  // spool it right away rather than on its next poll.
+  void OnNewPageAvailable();
+
   // Asks for the worker thread to finish its queued tasks and disconnects the
   // delegate object. The PrintJobManager will remove its reference. This may
   // have the side-effect of destroying the object if the caller doesn't have a
@@ -9,6 +9,7 @@
 #include "base/callback.h"
 #include "base/compiler_specific.h"
 #include "base/message_loop/message_loop.h"
+#include "base/metrics/histogram.h"
 #include "base/values.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/chrome_notification_types.h"
@@ -52,6 +53,7 @@ void NotificationCallback(PrintJobWorkerOwner* print_job,
 PrintJobWorker::PrintJobWorker(PrintJobWorkerOwner* owner)
     : Thread("Printing_Worker"),
       owner_(owner),
+      pages_spooled_(0),
       weak_factory_(this) {
   // The object is created in the IO thread.
   DCHECK_EQ(owner_->message_loop(), base::MessageLoop::current());
@@ -221,6 +223,8 @@ void PrintJobWorker::StartPrinting(PrintedDocument* new_document) {
     document_name = printing::SimplifyDocumentTitle(
         l10n_util::GetStringUTF16(IDS_DEFAULT_PRINT_DOCUMENT_TITLE));
   }
+  printing_start_time_ = base::TimeTicks::Now();
+  pages_spooled_ = 0;
   PrintingContext::Result result =
       printing_context_->NewDocument(document_name);
   if (result != PrintingContext::OK) {
@@ -254,6 +258,10 @@ void PrintJobWorker::OnNewPage() {
   // message_loop() could return NULL when the print job is cancelled.
   DCHECK_EQ(message_loop(), base::MessageLoop::current());
 
+  // This call supersedes any pending poll; a new one is scheduled below if the
+  // next page still isn't there.
+  weak_factory_.InvalidateWeakPtrs();
+
   if (page_number_ == PageNumber::npos()) {
     // Find first page to print.
     int page_count = document_->page_count();
@@ -274,7 +282,8 @@ void PrintJobWorker::OnNewPage() {
     // Is the page available?
     scoped_refptr<PrintedPage> page;
     if (!document_->GetPage(page_number_.ToInt(), &page)) {
-      // We need to wait for the page to be available.
+      // We need to wait for the page to be available. PrintJob calls
+      // OnNewPage() as soon as it is; the poll is only a fallback.
       base::MessageLoop::current()->PostDelayedTask(
           FROM_HERE,
           base::Bind(&PrintJobWorker::OnNewPage, weak_factory_.GetWeakPtr()),
@@ -309,6 +318,10 @@ void PrintJobWorker::OnDocumentDone() {
     return;
   }
 
+  UMA_HISTOGRAM_LONG_TIMES("Printing.Worker.JobTime",
+                           base::TimeTicks::Now() - printing_start_time_);
+  UMA_HISTOGRAM_COUNTS_10000("Printing.Worker.PagesSpooled", pages_spooled_);
+
   owner_->message_loop()->PostTask(
       FROM_HERE, base::Bind(NotificationCallback, make_scoped_refptr(owner_),
                             JobEventDetails::DOC_DONE, document_,
@@ -359,6 +372,11 @@ void PrintJobWorker::SpoolPage(PrintedPage* page) {
     return;
   }
 
+  if (++pages_spooled_ == 1) {
+    UMA_HISTOGRAM_TIMES("Printing.Worker.TimeToFirstPage",
+                        base::TimeTicks::Now() - printing_start_time_);
+  }
+
   // Signal everyone that the page is printed.
   owner_->message_loop()->PostTask(
       FROM_HERE,
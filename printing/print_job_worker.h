@@ -9,6 +9,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/threading/thread.h"
+#include "base/time/time.h"
 #include "printing/page_number.h"
 #include "printing/print_destination_interface.h"
 #include "printing/printing_context.h"
@@ -63,9 +64,9 @@ class PrintJobWorker : public base::Thread {
   // Updates the printed document.
   void OnDocumentChanged(PrintedDocument* new_document);
 
-  // Dequeues waiting pages. Called when PrintJob receives a
-  // NOTIFY_PRINTED_DOCUMENT_UPDATED notification. It's time to look again if
-  // the next page can be printed.
+  // Dequeues waiting pages. Called when PrintJob is told that a page was added
+  // to the document, and periodically while waiting for pages. It's time to
+  // look again if the next page can be printed.
   void OnNewPage();
 
   // This is the only function that can be called in a thread.
@@ -134,7 +135,13 @@ class PrintJobWorker : public base::Thread {
   // Current page number to print.
   PageNumber page_number_;
 
-  // Used to generate a WeakPtr for callbacks.
+  // When StartPrinting() was called, and the number of pages spooled since,
+  // for metrics.
+  base::TimeTicks printing_start_time_;
+  int pages_spooled_;
+
+  // Used to generate a WeakPtr for callbacks. Invalidated whenever
+  // OnNewPage() runs, so that at most one poll for pages is pending.
   base::WeakPtrFactory<PrintJobWorker> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(PrintJobWorker);
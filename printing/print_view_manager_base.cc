@@ -155,6 +155,7 @@ void PrintViewManagerBase::OnPdfToEmfConverted(
                       params.page_size,
                       params.content_area);
   }
+  print_job_->OnNewPageAvailable();
 
   ShouldQuitFromInnerMessageLoop();
 }
@@ -224,6 +225,7 @@ void PrintViewManagerBase::OnDidPrintPage(
     params.actual_shrink,
     params.page_size,
     params.content_area);
+  print_job_->OnNewPageAvailable();
 
   ShouldQuitFromInnerMessageLoop();
 #else
@@ -34,6 +34,7 @@
 
 namespace base {
 class CommandLine;
+class TimeDelta;
 }
 
 // ProcessSingleton ----------------------------------------------------------
@@ -90,6 +91,18 @@ class ProcessSingleton : public base::NonThreadSafe {
   void Cleanup();
 
 #if defined(OS_POSIX) && !defined(OS_ANDROID)
+  // Hands |command_line| to an already running browser if one is listening
+  // on the singleton socket. Unlike NotifyOtherProcessOrCreate(), this makes a
+  // single connection attempt and neither inspects the lock nor waits for a
+  // browser that is still starting, so it is cheap enough to call before most
+  // of startup. Once the command line has been sent, the browser is only
+  // given a fraction of a second to acknowledge it, and a missing
+  // acknowledgement still counts as handed over. Returns PROCESS_NOTIFIED if
+  // the running browser has the command line, otherwise PROCESS_NONE, and the
+  // caller must then go through NotifyOtherProcessOrCreate() as usual.
+  NotifyResult NotifyRunningProcessFastPath(
+      const base::CommandLine& command_line);
+
   static void DisablePromptForTesting();
 #endif
 
@@ -146,6 +159,13 @@ class ProcessSingleton : public base::NonThreadSafe {
   // Default function to kill a process, overridable by tests.
   void KillProcess(int pid);
 
+  // Sends |command_line| over the connected |socket| and waits up to
+  // |timeout| for the other process to acknowledge it.
+  NotifyResult SendCommandLine(int socket,
+                               const base::CommandLine& command_line,
+                               const base::TimeDelta& timeout,
+                               bool kill_unresponsive);
+
   // Allow overriding for tests.
   base::ProcessId current_pid_;
 
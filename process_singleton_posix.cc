@@ -48,6 +48,7 @@
 #include <sys/un.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstring>
 #include <set>
 #include <string>
@@ -105,6 +106,16 @@ const int kMaxACKMessageLength = arraysize(kShutdownToken) - 1;
 
 const char kLockDelimiter = '-';
 
+// Delays between attempts to connect to a browser that holds the lock but is
+// not listening yet. The delay doubles after each attempt.
+const int kInitialConnectRetryDelayMs = 10;
+const int kMaxConnectRetryDelayMs = 1000;
+
+// How long NotifyRunningProcessFastPath() waits for the running browser to
+// acknowledge a command line it has been sent. A browser that is listening
+// answers within milliseconds.
+const int kFastPathAckTimeoutMs = 500;
+
 // Set a file descriptor to be non-blocking.
 // Return 0 on success, -1 on failure.
 int SetNonBlocking(int fd) {
@@ -157,26 +168,37 @@ bool WriteToSocket(int fd, const char *message, size_t length) {
   return true;
 }
 
-// Wait a socket for read for a certain timeout in seconds.
+// Converts |delta| to a timeval for select() and socket options.
+timeval ToTimeVal(const base::TimeDelta& delta) {
+  int64 microseconds = delta.InMicroseconds();
+  timeval tv = {
+    static_cast<time_t>(microseconds / base::Time::kMicrosecondsPerSecond),
+    static_cast<suseconds_t>(microseconds % base::Time::kMicrosecondsPerSecond)
+  };
+  return tv;
+}
+
+// Wait a socket for read for a certain timeout.
 // Returns -1 if error occurred, 0 if timeout reached, > 0 if the socket is
 // ready for read.
-int WaitSocketForRead(int fd, int timeout) {
+int WaitSocketForRead(int fd, const base::TimeDelta& timeout) {
   fd_set read_fds;
-  struct timeval tv;
+  struct timeval tv = ToTimeVal(timeout);
 
   FD_ZERO(&read_fds);
   FD_SET(fd, &read_fds);
-  tv.tv_sec = timeout;
-  tv.tv_usec = 0;
 
   return HANDLE_EINTR(select(fd + 1, &read_fds, NULL, NULL, &tv));
 }
 
-// Read a message from a socket fd, with an optional timeout in seconds.
+// Read a message from a socket fd, with an optional timeout.
 // If |timeout| <= 0 then read immediately.
 // Return number of bytes actually read, or -1 on error.
-ssize_t ReadFromSocket(int fd, char *buf, size_t bufsize, int timeout) {
-  if (timeout > 0) {
+ssize_t ReadFromSocket(int fd,
+                       char *buf,
+                       size_t bufsize,
+                       const base::TimeDelta& timeout) {
+  if (timeout > base::TimeDelta()) {
     int rv = WaitSocketForRead(fd, timeout);
     if (rv <= 0)
       return rv;
@@ -204,6 +226,37 @@ ssize_t ReadFromSocket(int fd, char *buf, size_t bufsize, int timeout) {
   return bytes_read;
 }
 
+// Formats |cmd_line| as the message handed to a running browser:
+// "START\0<current dir>\0<argv[0]>\0...\0<argv[n]>".
+bool BuildStartMessage(const CommandLine& cmd_line, std::string* message) {
+  base::FilePath current_dir;
+  if (!PathService::Get(base::DIR_CURRENT, &current_dir))
+    return false;
+
+  message->assign(kStartToken);
+  message->push_back(kTokenDelimiter);
+  message->append(current_dir.value());
+
+  const std::vector<std::string>& argv = cmd_line.argv();
+  for (std::vector<std::string>::const_iterator it = argv.begin();
+      it != argv.end(); ++it) {
+    message->push_back(kTokenDelimiter);
+    message->append(*it);
+  }
+  return true;
+}
+
+// Tells the window manager that startup is complete when another browser
+// takes over our command line.
+void NotifyWindowManagerStartupComplete() {
+#if defined(TOOLKIT_VIEWS) && !defined(OS_CHROMEOS)
+  // Likely NULL in unit tests.
+  views::LinuxUI* linux_ui = views::LinuxUI::instance();
+  if (linux_ui)
+    linux_ui->NotifyWindowManagerStartupComplete();
+#endif
+}
+
 // Set up a sockaddr appropriate for messaging.
 void SetupSockAddr(const std::string& path, struct sockaddr_un* addr) {
   addr->sun_family = AF_UNIX;
@@ -754,8 +807,14 @@ ProcessSingleton::NotifyResult ProcessSingleton::NotifyOtherProcessWithTimeout(
     bool kill_unresponsive) {
   DCHECK_GE(timeout_seconds, 0);
 
+  // A browser that has just taken the lock usually starts listening within a
+  // few milliseconds, so retry quickly at first.
+  const base::TimeTicks deadline = base::TimeTicks::Now() +
+      base::TimeDelta::FromSeconds(timeout_seconds);
+  base::TimeDelta retry_delay =
+      base::TimeDelta::FromMilliseconds(kInitialConnectRetryDelayMs);
   ScopedSocket socket;
-  for (int retries = 0; retries <= timeout_seconds; ++retries) {
+  for (;;) {
     // Try to connect to the socket.
     if (ConnectSocket(&socket, socket_path_, cookie_path_))
       break;
@@ -801,52 +860,94 @@ ProcessSingleton::NotifyResult ProcessSingleton::NotifyOtherProcessWithTimeout(
       return PROCESS_NONE;
     }
 
-    if (retries == timeout_seconds) {
+    base::TimeTicks now = base::TimeTicks::Now();
+    if (now >= deadline) {
       // Retries failed.  Kill the unresponsive chrome process and continue.
       if (!kill_unresponsive || !KillProcessByLockPath())
         return PROFILE_IN_USE;
       return PROCESS_NONE;
     }
 
-    base::PlatformThread::Sleep(base::TimeDelta::FromSeconds(1));
+    base::PlatformThread::Sleep(std::min(retry_delay, deadline - now));
+    retry_delay = std::min(
+        retry_delay * 2,
+        base::TimeDelta::FromMilliseconds(kMaxConnectRetryDelayMs));
   }
 
-  timeval timeout = {timeout_seconds, 0};
-  setsockopt(socket.fd(), SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+  return SendCommandLine(socket.fd(), cmd_line,
+                         base::TimeDelta::FromSeconds(timeout_seconds),
+                         kill_unresponsive);
+}
 
-  // Found another process, prepare our command line
-  // format is "START\0<current dir>\0<argv[0]>\0...\0<argv[n]>".
-  std::string to_send(kStartToken);
-  to_send.push_back(kTokenDelimiter);
+ProcessSingleton::NotifyResult ProcessSingleton::NotifyRunningProcessFastPath(
+    const CommandLine& command_line) {
+  ScopedSocket socket;
+  if (!ConnectSocket(&socket, socket_path_, cookie_path_))
+    return PROCESS_NONE;
 
-  base::FilePath current_dir;
-  if (!PathService::Get(base::DIR_CURRENT, &current_dir))
+  const base::TimeDelta timeout =
+      base::TimeDelta::FromMilliseconds(kFastPathAckTimeoutMs);
+  timeval send_timeout = ToTimeVal(timeout);
+  setsockopt(socket.fd(), SOL_SOCKET, SO_SNDTIMEO, &send_timeout,
+             sizeof(send_timeout));
+
+  std::string to_send;
+  if (!BuildStartMessage(command_line, &to_send) ||
+      !WriteToSocket(socket.fd(), to_send.data(), to_send.length())) {
+    // Nothing was handed over; NotifyOtherProcessOrCreate() deals with
+    // browsers that are not responding.
     return PROCESS_NONE;
-  to_send.append(current_dir.value());
+  }
 
-  const std::vector<std::string>& argv = cmd_line.argv();
-  for (std::vector<std::string>::const_iterator it = argv.begin();
-      it != argv.end(); ++it) {
-    to_send.push_back(kTokenDelimiter);
-    to_send.append(*it);
+  if (shutdown(socket.fd(), SHUT_WR) < 0)
+    PLOG(ERROR) << "shutdown() failed";
+
+  // The running browser has the whole command line now. Sending it again
+  // through the regular path would open it twice, so a browser that is slow
+  // to acknowledge is assumed to be handling it. Only a browser that says it
+  // is shutting down leaves the command line to this process.
+  char buf[kMaxACKMessageLength + 1];
+  ssize_t len =
+      ReadFromSocket(socket.fd(), buf, kMaxACKMessageLength, timeout);
+  if (len > 0) {
+    buf[len] = '\0';
+    if (strncmp(buf, kShutdownToken, arraysize(kShutdownToken) - 1) == 0)
+      return PROCESS_NONE;
   }
 
+  NotifyWindowManagerStartupComplete();
+  return PROCESS_NOTIFIED;
+}
+
+ProcessSingleton::NotifyResult ProcessSingleton::SendCommandLine(
+    int socket,
+    const CommandLine& cmd_line,
+    const base::TimeDelta& timeout,
+    bool kill_unresponsive) {
+  timeval send_timeout = ToTimeVal(timeout);
+  setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &send_timeout,
+             sizeof(send_timeout));
+
+  // Found another process, prepare our command line.
+  std::string to_send;
+  if (!BuildStartMessage(cmd_line, &to_send))
+    return PROCESS_NONE;
+
   // Send the message
-  if (!WriteToSocket(socket.fd(), to_send.data(), to_send.length())) {
+  if (!WriteToSocket(socket, to_send.data(), to_send.length())) {
     // Try to kill the other process, because it might have been dead.
     if (!kill_unresponsive || !KillProcessByLockPath())
       return PROFILE_IN_USE;
     return PROCESS_NONE;
   }
 
-  if (shutdown(socket.fd(), SHUT_WR) < 0)
+  if (shutdown(socket, SHUT_WR) < 0)
     PLOG(ERROR) << "shutdown() failed";
 
   // Read ACK message from the other process. It might be blocked for a certain
   // timeout, to make sure the other process has enough time to return ACK.
   char buf[kMaxACKMessageLength + 1];
-  ssize_t len =
-      ReadFromSocket(socket.fd(), buf, kMaxACKMessageLength, timeout_seconds);
+  ssize_t len = ReadFromSocket(socket, buf, kMaxACKMessageLength, timeout);
 
   // Failed to read ACK, the other process might have been frozen.
   if (len <= 0) {
@@ -860,12 +961,7 @@ ProcessSingleton::NotifyResult ProcessSingleton::NotifyOtherProcessWithTimeout(
     // The other process is shutting down, it's safe to start a new process.
     return PROCESS_NONE;
   } else if (strncmp(buf, kACKToken, arraysize(kACKToken) - 1) == 0) {
-#if defined(TOOLKIT_VIEWS) && !defined(OS_CHROMEOS)
-    // Likely NULL in unit tests.
-    views::LinuxUI* linux_ui = views::LinuxUI::instance();
-    if (linux_ui)
-      linux_ui->NotifyWindowManagerStartupComplete();
-#endif
+    NotifyWindowManagerStartupComplete();
 
     // Assume the other process is handling the request.
     return PROCESS_NOTIFIED;
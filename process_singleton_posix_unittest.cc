@@ -26,6 +26,7 @@
 #include "base/test/test_timeouts.h"
 #include "base/test/thread_test_helper.h"
 #include "base/threading/thread.h"
+#include "base/time/time.h"
 #include "chrome/common/chrome_constants.h"
 #include "content/public/test/test_browser_thread.h"
 #include "net/base/net_util.h"
@@ -220,6 +221,17 @@ class ProcessSingletonPosixTest : public testing::Test {
     signal_event_.Wait();  // Ensure thread unblocks before continuing.
   }
 
+  // Waits until messages read on the IO thread have been handled by the
+  // worker thread.
+  void FlushThreads() {
+    scoped_refptr<base::ThreadTestHelper> io_helper(new base::ThreadTestHelper(
+        BrowserThread::GetMessageLoopProxyForThread(BrowserThread::IO).get()));
+    ASSERT_TRUE(io_helper->Run());
+    scoped_refptr<base::ThreadTestHelper> helper(
+        new base::ThreadTestHelper(worker_thread_->message_loop_proxy().get()));
+    ASSERT_TRUE(helper->Run());
+  }
+
   void BlockThread() {
     wait_event_.Wait();
     signal_event_.Signal();
@@ -406,6 +418,58 @@ TEST_F(ProcessSingletonPosixTest, NotifyOtherProcessOrCreate_BadCookie) {
             NotifyOtherProcessOrCreate(url, TestTimeouts::action_timeout()));
 }
 
+// Test that the fast path hands the command line to a running browser.
+TEST_F(ProcessSingletonPosixTest, NotifyRunningProcessFastPath) {
+  CreateProcessSingletonOnThread();
+
+  scoped_ptr<TestableProcessSingleton> process_singleton(
+      CreateProcessSingleton());
+  CommandLine command_line(CommandLine::ForCurrentProcess()->GetProgram());
+  command_line.AppendArg("about:blank");
+
+  EXPECT_EQ(ProcessSingleton::PROCESS_NOTIFIED,
+            process_singleton->NotifyRunningProcessFastPath(command_line));
+  CheckNotified();
+}
+
+// Test that the fast path doesn't wait long for a browser that is slow to
+// acknowledge, and that the command line it sent is still handled, once.
+TEST_F(ProcessSingletonPosixTest, NotifyRunningProcessFastPathSlowAck) {
+  CreateProcessSingletonOnThread();
+
+  scoped_ptr<TestableProcessSingleton> process_singleton(
+      CreateProcessSingleton());
+  CommandLine command_line(CommandLine::ForCurrentProcess()->GetProgram());
+  command_line.AppendArg("about:blank");
+
+  BlockWorkerThread();
+  base::TimeTicks start = base::TimeTicks::Now();
+  EXPECT_EQ(ProcessSingleton::PROCESS_NOTIFIED,
+            process_singleton->NotifyRunningProcessFastPath(command_line));
+  EXPECT_LT(base::TimeTicks::Now() - start, base::TimeDelta::FromSeconds(5));
+  UnblockWorkerThread();
+
+  FlushThreads();
+  CheckNotified();
+}
+
+// Test that the fast path gives up immediately when no browser is listening on
+// the socket.
+TEST_F(ProcessSingletonPosixTest, NotifyRunningProcessFastPathNoListener) {
+  CreateProcessSingletonOnThread();
+  EXPECT_EQ(0, unlink(socket_path_.value().c_str()));
+
+  scoped_ptr<TestableProcessSingleton> process_singleton(
+      CreateProcessSingleton());
+  CommandLine command_line(CommandLine::ForCurrentProcess()->GetProgram());
+  command_line.AppendArg("about:blank");
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  EXPECT_EQ(ProcessSingleton::PROCESS_NONE,
+            process_singleton->NotifyRunningProcessFastPath(command_line));
+  EXPECT_LT(base::TimeTicks::Now() - start, base::TimeDelta::FromSeconds(1));
+}
+
 #if defined(OS_MACOSX)
 // Test that if there is an existing lock file, and we could not flock()
 // it, then exit.
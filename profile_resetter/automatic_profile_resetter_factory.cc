@@ -63,7 +63,9 @@ void AutomaticProfileResetterFactory::RegisterProfilePrefs(
 
 bool AutomaticProfileResetterFactory::
     ServiceIsCreatedWithBrowserContext() const {
-  return true;
+  // Created by a deferred startup task once the first browser window has been
+  // shown, see ProfileManager::DoFinalInitForServices().
+  return false;
 }
 
 bool AutomaticProfileResetterFactory::ServiceIsNULLWhileTesting() const {
@@ -0,0 +1,77 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/command_line.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "chrome/browser/browser_process.h"
+#include "chrome/browser/profiles/profile.h"
+#include "chrome/browser/profiles/profile_manager.h"
+#include "chrome/browser/ui/browser.h"
+#include "chrome/common/chrome_switches.h"
+#include "chrome/test/base/in_process_browser_test.h"
+#include "content/public/test/test_utils.h"
+#include "testing/perf/perf_test.h"
+
+namespace {
+
+// Number of profiles loaded to get a first window time.
+const int kProfileCount = 5;
+
+}  // namespace
+
+// Measures the time from loading a profile to showing its first browser
+// window, with the creation of non-critical keyed services deferred until
+// after the window is shown (the parameter is true) or done while the profile
+// loads.
+class DeferredStartupPerfBrowserTest
+    : public InProcessBrowserTest,
+      public testing::WithParamInterface<bool> {
+ public:
+  DeferredStartupPerfBrowserTest() {}
+
+  virtual void SetUpCommandLine(CommandLine* command_line) OVERRIDE {
+    if (!GetParam()) {
+      command_line->AppendSwitchASCII(switches::kForceFieldTrials,
+                                      "DeferredStartupTasks/Disabled/");
+    }
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(DeferredStartupPerfBrowserTest);
+};
+
+// This is manual as it creates several profiles and only reports timings.
+IN_PROC_BROWSER_TEST_P(DeferredStartupPerfBrowserTest,
+                       MANUAL_TimeToFirstWindow) {
+  ProfileManager* profile_manager = g_browser_process->profile_manager();
+  base::TimeDelta first_window_time;
+  base::TimeDelta settled_time;
+  for (int i = 0; i < kProfileCount; ++i) {
+    const base::FilePath profile_path =
+        profile_manager->user_data_dir().AppendASCII(
+            base::StringPrintf("Perf %d", i));
+    const base::TimeTicks start = base::TimeTicks::Now();
+    Profile* profile = profile_manager->GetProfile(profile_path);
+    ASSERT_TRUE(profile);
+    CreateBrowser(profile);
+    first_window_time += base::TimeTicks::Now() - start;
+
+    // Let the deferred tasks run, so they don't overlap with the next profile.
+    content::RunAllPendingInMessageLoop();
+    settled_time += base::TimeTicks::Now() - start;
+  }
+
+  const std::string trace = GetParam() ? "deferred" : "immediate";
+  perf_test::PrintResult(
+      "deferred_startup", "", "time_to_first_window_" + trace,
+      first_window_time.InMillisecondsF() / kProfileCount, "ms", true);
+  perf_test::PrintResult(
+      "deferred_startup", "", "time_to_idle_" + trace,
+      settled_time.InMillisecondsF() / kProfileCount, "ms", true);
+}
+
+INSTANTIATE_TEST_CASE_P(DeferredStartupPerfBrowserTest,
+                        DeferredStartupPerfBrowserTest,
+                        testing::Bool());
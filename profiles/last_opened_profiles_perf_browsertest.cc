@@ -0,0 +1,127 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "base/command_line.h"
+#include "base/file_util.h"
+#include "base/json/json_writer.h"
+#include "base/path_service.h"
+#include "base/prefs/pref_service.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "chrome/browser/browser_process.h"
+#include "chrome/browser/profiles/profile.h"
+#include "chrome/browser/profiles/profile_manager.h"
+#include "chrome/common/chrome_constants.h"
+#include "chrome/common/chrome_paths.h"
+#include "chrome/common/chrome_switches.h"
+#include "chrome/common/pref_names.h"
+#include "chrome/test/base/in_process_browser_test.h"
+#include "components/bookmarks/common/bookmark_constants.h"
+#include "testing/perf/perf_test.h"
+
+namespace {
+
+const int kProfileCount = 5;
+
+// Rough size of the Preferences and Bookmarks files of a long used profile.
+const int kProfileFileEntries = 20000;
+
+std::string ProfileName(int index) {
+  return base::StringPrintf("Perf Profile %d", index);
+}
+
+// Writes a JSON dictionary with |entries| string values to |path|.
+bool WriteLargeJsonFile(const base::FilePath& path, int entries) {
+  base::DictionaryValue padding;
+  for (int i = 0; i < entries; ++i) {
+    padding.SetStringWithoutPathExpansion(
+        "entry" + base::IntToString(i), std::string(40, 'x'));
+  }
+  base::DictionaryValue root;
+  root.Set("perf_padding", padding.DeepCopy());
+  std::string json;
+  base::JSONWriter::Write(&root, &json);
+  return base::WriteFile(path, json.data(), json.size()) ==
+      static_cast<int>(json.size());
+}
+
+}  // namespace
+
+// Measures how long GetLastOpenedProfiles() takes to load five on-disk
+// profiles with large Preferences and Bookmarks files, with their files
+// warmed on the blocking pool (the parameter is true) or not.
+class LastOpenedProfilesPerfBrowserTest
+    : public InProcessBrowserTest,
+      public testing::WithParamInterface<bool> {
+ public:
+  LastOpenedProfilesPerfBrowserTest() {}
+
+  virtual void SetUpCommandLine(CommandLine* command_line) OVERRIDE {
+    if (!GetParam()) {
+      command_line->AppendSwitchASCII(switches::kForceFieldTrials,
+                                      "WarmLastOpenedProfileFiles/Disabled/");
+    }
+  }
+
+  virtual bool SetUpUserDataDirectory() OVERRIDE {
+    base::FilePath user_data_dir;
+    if (!PathService::Get(chrome::DIR_USER_DATA, &user_data_dir))
+      return false;
+    for (int i = 0; i < kProfileCount; ++i) {
+      base::FilePath profile_dir = user_data_dir.AppendASCII(ProfileName(i));
+      if (!base::CreateDirectory(profile_dir) ||
+          !WriteLargeJsonFile(profile_dir.Append(chrome::kPreferencesFilename),
+                              kProfileFileEntries) ||
+          !WriteLargeJsonFile(profile_dir.Append(bookmarks::kBookmarksFileName),
+                              kProfileFileEntries)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(LastOpenedProfilesPerfBrowserTest);
+};
+
+// This is manual because the profile files are written by the test and are
+// usually still in the OS page cache, where warming them has nothing left to
+// do. For cold start numbers, drop the page cache (as root, e.g. through
+// /proc/sys/vm/drop_caches on Linux) while the test waits for input, which
+// it does when run with --wait-for-cache-drop.
+IN_PROC_BROWSER_TEST_P(LastOpenedProfilesPerfBrowserTest,
+                       MANUAL_LoadFiveProfiles) {
+  if (CommandLine::ForCurrentProcess()->HasSwitch("wait-for-cache-drop")) {
+    printf("Drop the page cache, then press enter.\n");
+    getchar();
+  }
+
+  base::ListValue profile_list;
+  for (int i = 0; i < kProfileCount; ++i)
+    profile_list.AppendString(ProfileName(i));
+  g_browser_process->local_state()->Set(prefs::kProfilesLastActive,
+                                        profile_list);
+
+  ProfileManager* profile_manager = g_browser_process->profile_manager();
+  const base::TimeTicks start = base::TimeTicks::Now();
+  std::vector<Profile*> profiles = profile_manager->GetLastOpenedProfiles();
+  const base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+  ASSERT_EQ(static_cast<size_t>(kProfileCount), profiles.size());
+  perf_test::PrintResult(
+      "last_opened_profiles", "",
+      GetParam() ? "load_five_warmed" : "load_five_unwarmed",
+      elapsed.InMillisecondsF(), "ms", true);
+}
+
+INSTANTIATE_TEST_CASE_P(LastOpenedProfilesPerfBrowserTest,
+                        LastOpenedProfilesPerfBrowserTest,
+                        testing::Bool());
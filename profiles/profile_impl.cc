@@ -106,6 +106,10 @@
 #include "grit/generated_resources.h"
 #include "ui/base/l10n/l10n_util.h"
 
+#if defined(OS_LINUX)
+#include "chrome/browser/profiles/profile_startup_prefetcher_linux.h"
+#endif
+
 #if defined(OS_ANDROID)
 #include "chrome/browser/media/protected_media_identifier_permission_context.h"
 #include "chrome/browser/media/protected_media_identifier_permission_context_factory.h"
@@ -285,6 +289,11 @@ Profile* Profile::CreateProfile(const base::FilePath& path,
   scoped_refptr<base::SequencedTaskRunner> sequenced_task_runner =
       JsonPrefStore::GetTaskRunnerForFile(path,
                                           BrowserThread::GetBlockingPool());
+#if defined(OS_LINUX)
+  // Start reading ahead the profile's databases while the rest of the profile
+  // and the UI initialize.
+  profile_startup_prefetcher::Start(path);
+#endif
   if (create_mode == CREATE_MODE_ASYNCHRONOUS) {
     DCHECK(delegate);
     CreateProfileDirectory(sequenced_task_runner.get(), path);
@@ -11,14 +11,17 @@
 #include "base/debug/trace_event.h"
 #include "base/deferred_sequenced_task_runner.h"
 #include "base/file_util.h"
+#include "base/files/file.h"
 #include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
+#include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
 #include "base/prefs/pref_service.h"
 #include "base/prefs/scoped_user_pref_update.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "chrome/browser/bookmarks/bookmark_model_factory.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/chrome_notification_types.h"
@@ -47,6 +50,7 @@
 #include "chrome/common/pref_names.h"
 #include "chrome/common/url_constants.h"
 #include "components/bookmarks/browser/bookmark_model.h"
+#include "components/bookmarks/common/bookmark_constants.h"
 #include "components/signin/core/common/profile_management_switches.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/notification_service.h"
@@ -66,6 +70,14 @@
 #include "chrome/browser/managed_mode/managed_user_service_factory.h"
 #endif
 
+#if defined(ENABLE_EXTENSIONS)
+#include "chrome/browser/apps/ephemeral_app_service_factory.h"
+#endif
+
+#if !defined(OS_ANDROID)
+#include "chrome/browser/profile_resetter/automatic_profile_resetter_factory.h"
+#endif
+
 #if !defined(OS_IOS)
 #include "chrome/browser/extensions/extension_service.h"
 #include "chrome/browser/sessions/session_service_factory.h"
@@ -216,6 +228,69 @@ size_t GetEnabledAppCount(Profile* profile) {
 
 #endif  // ENABLE_EXTENSIONS
 
+// Field trial used to compare loading the last opened profiles with and
+// without WarmProfileFiles(). In the "Disabled" group no files are warmed.
+const char kWarmProfileFilesFieldTrialName[] = "WarmLastOpenedProfileFiles";
+
+bool IsProfileFileWarmingEnabled() {
+  return base::FieldTrialList::FindFullName(
+      kWarmProfileFilesFieldTrialName) != "Disabled";
+}
+
+// Runs on the blocking pool. Creates |profile_dir| if needed and reads the
+// files that loading the profile parses in full, so that they are in the OS
+// page cache by the time the profile is created on the UI thread. Several
+// profiles can be warmed in parallel while an earlier profile is still being
+// created. Databases such as History are left alone: SQLite only touches the
+// pages it needs, so reading some fixed part of them ahead does little.
+void WarmProfileFiles(const base::FilePath& profile_dir) {
+  TRACE_EVENT0("browser", "ProfileManager::WarmProfileFiles");
+  if (!base::PathExists(profile_dir)) {
+    base::CreateDirectory(profile_dir);
+    return;
+  }
+
+  const base::FilePath::CharType* const kFilesToWarm[] = {
+    chrome::kPreferencesFilename,
+    bookmarks::kBookmarksFileName,
+  };
+  const int kBufferSize = 64 * 1024;
+  scoped_ptr<char[]> buffer(new char[kBufferSize]);
+  for (size_t i = 0; i < arraysize(kFilesToWarm); ++i) {
+    base::File file(profile_dir.Append(kFilesToWarm[i]),
+                    base::File::FLAG_OPEN | base::File::FLAG_READ);
+    if (!file.IsValid())
+      continue;
+    while (file.ReadAtCurrentPos(buffer.get(), kBufferSize) > 0) {}
+  }
+}
+
+// Registers the creation of keyed services that are not needed to show the
+// first browser window as deferred startup tasks, instead of creating them
+// along with the profile.
+void AddDeferredServiceStartupTasks(Profile* profile) {
+  StartupTaskRunnerService* startup_task_runner_service =
+      StartupTaskRunnerServiceFactory::GetForProfile(profile);
+  const std::vector<std::string> no_dependencies;
+#if defined(ENABLE_EXTENSIONS)
+  startup_task_runner_service->AddDeferredStartupTask(
+      "EphemeralAppService",
+      no_dependencies,
+      StartupTaskRunnerService::DEFERRED_STARTUP_TASK_PRIORITY_NORMAL,
+      base::Bind(base::IgnoreResult(&EphemeralAppServiceFactory::GetForProfile),
+                 profile));
+#endif
+#if !defined(OS_ANDROID)
+  startup_task_runner_service->AddDeferredStartupTask(
+      "AutomaticProfileResetter",
+      no_dependencies,
+      StartupTaskRunnerService::DEFERRED_STARTUP_TASK_PRIORITY_LOW,
+      base::Bind(base::IgnoreResult(
+                     &AutomaticProfileResetterFactory::GetForBrowserContext),
+                 static_cast<content::BrowserContext*>(profile)));
+#endif
+}
+
 } // namespace
 
 ProfileManager::ProfileManager(const base::FilePath& user_data_dir)
@@ -528,6 +603,7 @@ std::vector<Profile*> ProfileManager::GetLastOpenedProfiles(
     // Make a copy because the list might change in the calls to GetProfile.
     scoped_ptr<base::ListValue> profile_list(
         local_state->GetList(prefs::kProfilesLastActive)->DeepCopy());
+    std::vector<base::FilePath> profile_dirs;
     base::ListValue::const_iterator it;
     std::string profile;
     for (it = profile_list->begin(); it != profile_list->end(); ++it) {
@@ -535,8 +611,26 @@ std::vector<Profile*> ProfileManager::GetLastOpenedProfiles(
         LOG(WARNING) << "Invalid entry in " << prefs::kProfilesLastActive;
         continue;
       }
-      to_return.push_back(GetProfile(user_data_dir.AppendASCII(profile)));
+      profile_dirs.push_back(user_data_dir.AppendASCII(profile));
     }
+
+    TRACE_EVENT1("browser", "ProfileManager::GetLastOpenedProfiles",
+                 "profiles", profile_dirs.size());
+    // Profiles are created one after the other on the UI thread. Start the
+    // file I/O for all but the first one on the blocking pool now, so that it
+    // overlaps with the creation of the profiles before it.
+    const bool warm_profile_files = IsProfileFileWarmingEnabled();
+    for (size_t i = 1; warm_profile_files && i < profile_dirs.size(); ++i) {
+      if (GetProfileByPath(profile_dirs[i]))
+        continue;
+      BrowserThread::GetBlockingPool()->PostWorkerTaskWithShutdownBehavior(
+          FROM_HERE,
+          base::Bind(&WarmProfileFiles, profile_dirs[i]),
+          base::SequencedWorkerPool::CONTINUE_ON_SHUTDOWN);
+    }
+
+    for (size_t i = 0; i < profile_dirs.size(); ++i)
+      to_return.push_back(GetProfile(profile_dirs[i]));
   }
   return to_return;
 }
@@ -980,6 +1074,7 @@ void ProfileManager::DoFinalInitForServices(Profile* profile,
   // Start the deferred task runners once the profile is loaded.
   StartupTaskRunnerServiceFactory::GetForProfile(profile)->
       StartDeferredTaskRunners();
+  AddDeferredServiceStartupTasks(profile);
 
   AccountReconcilorFactory::GetForProfile(profile);
 }
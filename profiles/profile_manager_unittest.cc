@@ -7,9 +7,11 @@
 #include "base/command_line.h"
 #include "base/file_util.h"
 #include "base/files/scoped_temp_dir.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/path_service.h"
 #include "base/run_loop.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "base/values.h"
 #include "build/build_config.h"
 #include "chrome/browser/bookmarks/bookmark_model_factory.h"
@@ -745,6 +747,38 @@ TEST_F(ProfileManagerTest, LastOpenedProfilesDoesNotContainIncognito) {
   last_opened_profiles = profile_manager->GetLastOpenedProfiles();
   ASSERT_EQ(0U, last_opened_profiles.size());
 }
+
+// Loads five last opened profiles at once, as at startup, while their files
+// are being warmed on the blocking pool.
+TEST_F(ProfileManagerTest, LastOpenedProfilesLoadFive) {
+  const char* const kProfileNames[] = {
+    "Profile 1", "Profile 2", "Profile 3", "Profile 4", "Profile 5",
+  };
+  base::ListValue* profile_list = new base::ListValue;
+  for (size_t i = 0; i < arraysize(kProfileNames); ++i) {
+    base::FilePath profile_dir = temp_dir_.path().AppendASCII(kProfileNames[i]);
+    ASSERT_TRUE(base::CreateDirectory(profile_dir));
+    std::string prefs_contents("{}");
+    int prefs_size = base::checked_cast<int>(prefs_contents.size());
+    ASSERT_EQ(prefs_size,
+              base::WriteFile(profile_dir.Append(chrome::kPreferencesFilename),
+                              prefs_contents.data(),
+                              prefs_size));
+    profile_list->AppendString(kProfileNames[i]);
+  }
+  local_state_.Get()->SetUserPref(prefs::kProfilesLastActive, profile_list);
+
+  ProfileManager* profile_manager = g_browser_process->profile_manager();
+  std::vector<Profile*> last_opened_profiles =
+      profile_manager->GetLastOpenedProfiles();
+  BrowserThread::GetBlockingPool()->FlushForTesting();
+
+  ASSERT_EQ(arraysize(kProfileNames), last_opened_profiles.size());
+  for (size_t i = 0; i < arraysize(kProfileNames); ++i) {
+    EXPECT_EQ(temp_dir_.path().AppendASCII(kProfileNames[i]),
+              last_opened_profiles[i]->GetPath());
+  }
+}
 #endif  // !defined(OS_ANDROID)
 
 #if !defined(OS_ANDROID) && !defined(OS_CHROMEOS)
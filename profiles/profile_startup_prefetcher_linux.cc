@@ -0,0 +1,214 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/profiles/profile_startup_prefetcher_linux.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/debug/trace_event.h"
+#include "base/file_util.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/important_file_writer.h"
+#include "base/format_macros.h"
+#include "base/logging.h"
+#include "base/metrics/field_trial.h"
+#include "base/metrics/histogram.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/sequenced_worker_pool.h"
+#include "base/time/time.h"
+#include "chrome/common/chrome_constants.h"
+#include "components/webdata/common/webdata_constants.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
+
+namespace profile_startup_prefetcher {
+
+namespace {
+
+// Name of the access trace file in the profile directory.
+const base::FilePath::CharType kAccessTraceFilename[] =
+    FILE_PATH_LITERAL("Startup Access Trace");
+
+// Files whose access is traced. Only ranges of these files are read ahead,
+// whatever the trace file contains.
+const base::FilePath::CharType* const kTracedFiles[] = {
+  chrome::kHistoryFilename,
+  chrome::kFaviconsFilename,
+  kWebDataFilename,
+  chrome::kCookieFilename,
+  FILE_PATH_LITERAL("History Provider Cache"),
+};
+
+// Delay after profile creation at which the access trace is recorded, so that
+// it covers startup but not much of the rest of the session.
+const int kRecordAccessTraceDelaySeconds = 60;
+
+// Resident ranges separated by less than this are merged into one read.
+const int64 kMaxRangeGapBytes = 64 * 1024;
+
+// Upper bound on the number of resident bytes recorded for one file.
+const int64 kMaxTracedBytesPerFile = 16 * 1024 * 1024;
+
+// Access traces larger than this are ignored.
+const int64 kMaxAccessTraceBytes = 256 * 1024;
+
+// Field trial used to compare cold startup with and without read ahead. In
+// the "Disabled" group the trace is still recorded but not used.
+const char kProfileStartupPrefetchFieldTrialName[] = "ProfileStartupPrefetch";
+
+struct Range {
+  int64 offset;
+  int64 length;
+};
+
+bool IsTracedFile(const base::FilePath::StringType& name) {
+  for (size_t i = 0; i < arraysize(kTracedFiles); ++i) {
+    if (name == kTracedFiles[i])
+      return true;
+  }
+  return false;
+}
+
+// Appends to |ranges| the byte ranges of |file| whose pages are resident in
+// the page cache. Mapping the file and querying residency does not read it.
+void GetResidentRanges(base::File* file, std::vector<Range>* ranges) {
+  int64 file_size = file->GetLength();
+  if (file_size <= 0)
+    return;
+
+  void* address = mmap(NULL, file_size, PROT_READ, MAP_SHARED,
+                       file->GetPlatformFile(), 0);
+  if (address == MAP_FAILED)
+    return;
+
+  const int64 page_size = sysconf(_SC_PAGESIZE);
+  const size_t page_count = (file_size + page_size - 1) / page_size;
+  std::vector<unsigned char> residency(page_count);
+  if (mincore(address, file_size, &residency[0]) == 0) {
+    int64 traced_bytes = 0;
+    for (size_t i = 0;
+         i < page_count && traced_bytes < kMaxTracedBytesPerFile; ++i) {
+      if (!(residency[i] & 1))
+        continue;
+      int64 offset = i * page_size;
+      int64 length = std::min(page_size, file_size - offset);
+      traced_bytes += length;
+      if (!ranges->empty()) {
+        Range& last = ranges->back();
+        if (offset - (last.offset + last.length) <= kMaxRangeGapBytes) {
+          last.length = offset + length - last.offset;
+          continue;
+        }
+      }
+      Range range = { offset, length };
+      ranges->push_back(range);
+    }
+  }
+  munmap(address, file_size);
+}
+
+int64 PrefetchAndRecordMetrics(const base::FilePath& profile_dir) {
+  int64 bytes = PrefetchFromAccessTrace(profile_dir);
+  UMA_HISTOGRAM_MEMORY_KB("Startup.ProfileStartupPrefetchKB", bytes / 1024);
+  return bytes;
+}
+
+}  // namespace
+
+void Start(const base::FilePath& profile_dir) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  base::SequencedWorkerPool* pool = BrowserThread::GetBlockingPool();
+  if (base::FieldTrialList::FindFullName(
+          kProfileStartupPrefetchFieldTrialName) != "Disabled") {
+    pool->PostWorkerTaskWithShutdownBehavior(
+        FROM_HERE,
+        base::Bind(base::IgnoreResult(&PrefetchAndRecordMetrics), profile_dir),
+        base::SequencedWorkerPool::CONTINUE_ON_SHUTDOWN);
+  }
+  pool->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&RecordAccessTrace, profile_dir),
+      base::TimeDelta::FromSeconds(kRecordAccessTraceDelaySeconds));
+}
+
+int64 PrefetchFromAccessTrace(const base::FilePath& profile_dir) {
+  TRACE_EVENT0("startup", "profile_startup_prefetcher::PrefetchFromAccessTrace");
+  base::FilePath trace_path = profile_dir.Append(kAccessTraceFilename);
+  int64 trace_size = 0;
+  if (!base::GetFileSize(trace_path, &trace_size) ||
+      trace_size > kMaxAccessTraceBytes) {
+    return 0;
+  }
+  std::string contents;
+  if (!base::ReadFileToString(trace_path, &contents))
+    return 0;
+
+  std::vector<std::string> lines;
+  base::SplitString(contents, '\n', &lines);
+
+  int64 requested_bytes = 0;
+  base::FilePath::StringType current_name;
+  base::File current_file;
+  for (size_t i = 0; i < lines.size(); ++i) {
+    std::vector<std::string> fields;
+    base::SplitString(lines[i], '\t', &fields);
+    Range range;
+    if (fields.size() != 3 ||
+        !IsTracedFile(fields[0]) ||
+        !base::StringToInt64(fields[1], &range.offset) ||
+        !base::StringToInt64(fields[2], &range.length) ||
+        range.offset < 0 || range.length <= 0) {
+      continue;
+    }
+    if (fields[0] != current_name) {
+      current_name = fields[0];
+      current_file.Close();
+      current_file.Initialize(profile_dir.Append(current_name),
+                              base::File::FLAG_OPEN | base::File::FLAG_READ);
+    }
+    if (!current_file.IsValid())
+      continue;
+    // Starts asynchronous read ahead of the range into the page cache.
+    if (posix_fadvise(current_file.GetPlatformFile(), range.offset,
+                      range.length, POSIX_FADV_WILLNEED) == 0) {
+      requested_bytes += range.length;
+    }
+  }
+  return requested_bytes;
+}
+
+void RecordAccessTrace(const base::FilePath& profile_dir) {
+  TRACE_EVENT0("startup", "profile_startup_prefetcher::RecordAccessTrace");
+  std::string contents;
+  for (size_t i = 0; i < arraysize(kTracedFiles); ++i) {
+    base::File file(profile_dir.Append(kTracedFiles[i]),
+                    base::File::FLAG_OPEN | base::File::FLAG_READ);
+    if (!file.IsValid())
+      continue;
+    std::vector<Range> ranges;
+    GetResidentRanges(&file, &ranges);
+    for (size_t j = 0; j < ranges.size(); ++j) {
+      base::StringAppendF(&contents, "%s\t%" PRId64 "\t%" PRId64 "\n",
+                          kTracedFiles[i], ranges[j].offset, ranges[j].length);
+    }
+  }
+
+  if (!base::DirectoryExists(profile_dir))
+    return;
+  base::ImportantFileWriter::WriteFileAtomically(
+      profile_dir.Append(kAccessTraceFilename), contents);
+}
+
+}  // namespace profile_startup_prefetcher
@@ -0,0 +1,41 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_PROFILES_PROFILE_STARTUP_PREFETCHER_LINUX_H_
+#define CHROME_BROWSER_PROFILES_PROFILE_STARTUP_PREFETCHER_LINUX_H_
+
+#include "base/basictypes.h"
+
+namespace base {
+class FilePath;
+}
+
+// Warms the page cache with the parts of a profile's databases (History,
+// Favicons, Web Data, Cookies and the history quick provider cache) that were
+// used during the previous startup, so that opening them later in startup
+// does not incur cold random I/O.
+//
+// Some time after a profile has been loaded, the pages of those files that
+// are resident in the page cache are recorded as byte ranges in an access
+// trace file in the profile directory. When the profile is next created, the
+// kernel is asked to read ahead these ranges in the background while the UI
+// initializes.
+namespace profile_startup_prefetcher {
+
+// Schedules the read ahead of the ranges recorded for |profile_dir| and the
+// recording of a new access trace. Must be called on the UI thread, as early
+// as possible during profile creation.
+void Start(const base::FilePath& profile_dir);
+
+// Reads the access trace of |profile_dir| and issues the read ahead of the
+// recorded ranges. Returns the number of bytes requested. Blocking.
+int64 PrefetchFromAccessTrace(const base::FilePath& profile_dir);
+
+// Records the page cache residency of the profile's databases into the access
+// trace of |profile_dir|. Blocking.
+void RecordAccessTrace(const base::FilePath& profile_dir);
+
+}  // namespace profile_startup_prefetcher
+
+#endif  // CHROME_BROWSER_PROFILES_PROFILE_STARTUP_PREFETCHER_LINUX_H_
@@ -0,0 +1,73 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/profiles/profile_startup_prefetcher_linux.h"
+
+#include <string>
+
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "chrome/common/chrome_constants.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+const base::FilePath::CharType kAccessTraceFilename[] =
+    FILE_PATH_LITERAL("Startup Access Trace");
+
+class ProfileStartupPrefetcherTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  }
+
+  void WriteProfileFile(const base::FilePath::StringType& name,
+                        const std::string& contents) {
+    ASSERT_EQ(static_cast<int>(contents.size()),
+              base::WriteFile(temp_dir_.path().Append(name),
+                              contents.data(), contents.size()));
+  }
+
+  void WriteAccessTrace(const std::string& contents) {
+    WriteProfileFile(kAccessTraceFilename, contents);
+  }
+
+  base::ScopedTempDir temp_dir_;
+};
+
+}  // namespace
+
+TEST_F(ProfileStartupPrefetcherTest, NoTrace) {
+  EXPECT_EQ(0, profile_startup_prefetcher::PrefetchFromAccessTrace(
+      temp_dir_.path()));
+}
+
+TEST_F(ProfileStartupPrefetcherTest, RecordAndPrefetch) {
+  // The file was just written, so its pages are in the page cache.
+  WriteProfileFile(chrome::kHistoryFilename, std::string(64 * 1024, 'x'));
+  profile_startup_prefetcher::RecordAccessTrace(temp_dir_.path());
+
+  std::string trace;
+  ASSERT_TRUE(base::ReadFileToString(
+      temp_dir_.path().Append(kAccessTraceFilename), &trace));
+  EXPECT_EQ(0u, trace.find(chrome::kHistoryFilename));
+
+  EXPECT_EQ(64 * 1024, profile_startup_prefetcher::PrefetchFromAccessTrace(
+      temp_dir_.path()));
+}
+
+TEST_F(ProfileStartupPrefetcherTest, IgnoresInvalidEntries) {
+  WriteProfileFile(chrome::kHistoryFilename, std::string(8192, 'x'));
+  WriteProfileFile(FILE_PATH_LITERAL("Other"), std::string(8192, 'x'));
+  WriteAccessTrace("History\t0\t4096\n"
+                   "Other\t0\t4096\n"
+                   "History\t-1\t4096\n"
+                   "History\tfoo\t4096\n"
+                   "Favicons\t0\t4096\n"
+                   "History\t4096\t4096\n"
+                   "garbage\n");
+  EXPECT_EQ(8192, profile_startup_prefetcher::PrefetchFromAccessTrace(
+      temp_dir_.path()));
+}
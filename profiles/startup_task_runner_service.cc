@@ -4,12 +4,46 @@
 
 #include "chrome/browser/profiles/startup_task_runner_service.h"
 
+#include <set>
+
+#include "base/bind.h"
+#include "base/debug/trace_event.h"
 #include "base/deferred_sequenced_task_runner.h"
 #include "base/logging.h"
+#include "base/message_loop/message_loop.h"
+#include "base/metrics/field_trial.h"
+#include "base/metrics/histogram.h"
 #include "chrome/browser/profiles/profile.h"
 
+namespace {
+
+// Deferred startup tasks are started at the latest this long after the
+// profile has been loaded, for profiles that never show a browser window.
+const int kMaxDeferredStartupTaskDelaySeconds = 10;
+
+// Field trial used to compare startup with and without deferral. In the
+// "Disabled" group deferred startup tasks run as soon as they are added.
+const char kDeferredStartupTasksFieldTrialName[] = "DeferredStartupTasks";
+
+bool IsDeferralEnabled() {
+  return base::FieldTrialList::FindFullName(
+      kDeferredStartupTasksFieldTrialName) != "Disabled";
+}
+
+}  // namespace
+
+StartupTaskRunnerService::DeferredStartupTask::DeferredStartupTask()
+    : priority(DEFERRED_STARTUP_TASK_PRIORITY_NORMAL) {
+}
+
+StartupTaskRunnerService::DeferredStartupTask::~DeferredStartupTask() {
+}
+
 StartupTaskRunnerService::StartupTaskRunnerService(Profile* profile)
-    : profile_(profile) {
+    : profile_(profile),
+      deferred_startup_tasks_started_(false),
+      deferred_startup_task_scheduled_(false),
+      weak_factory_(this) {
 }
 
 StartupTaskRunnerService::~StartupTaskRunnerService() {
@@ -27,4 +61,116 @@ scoped_refptr<base::DeferredSequencedTaskRunner>
 
 void StartupTaskRunnerService::StartDeferredTaskRunners() {
   GetBookmarkTaskRunner()->Start();
+
+  if (!deferred_startup_tasks_started_) {
+    base::MessageLoop::current()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(&StartupTaskRunnerService::StartDeferredStartupTasks,
+                   weak_factory_.GetWeakPtr()),
+        base::TimeDelta::FromSeconds(kMaxDeferredStartupTaskDelaySeconds));
+  }
+}
+
+void StartupTaskRunnerService::AddDeferredStartupTask(
+    const std::string& name,
+    const std::vector<std::string>& dependencies,
+    DeferredStartupTaskPriority priority,
+    const base::Closure& task) {
+  DCHECK(CalledOnValidThread());
+  DCHECK(!task.is_null());
+
+  if (!IsDeferralEnabled()) {
+    TRACE_EVENT1("startup", "StartupTaskRunnerService::RunDeferredStartupTask",
+                 "name", name);
+    task.Run();
+    return;
+  }
+
+  DeferredStartupTask deferred_task;
+  deferred_task.name = name;
+  deferred_task.dependencies = dependencies;
+  deferred_task.priority = priority;
+  deferred_task.task = task;
+  deferred_startup_tasks_.push_back(deferred_task);
+
+  if (deferred_startup_tasks_started_)
+    ScheduleNextDeferredStartupTask();
+}
+
+void StartupTaskRunnerService::StartDeferredStartupTasks() {
+  DCHECK(CalledOnValidThread());
+  if (deferred_startup_tasks_started_)
+    return;
+
+  deferred_startup_tasks_started_ = true;
+  deferred_startup_tasks_start_time_ = base::TimeTicks::Now();
+  ScheduleNextDeferredStartupTask();
+}
+
+size_t StartupTaskRunnerService::GetNextDeferredStartupTask() const {
+  DCHECK(!deferred_startup_tasks_.empty());
+
+  std::set<std::string> pending_names;
+  for (size_t i = 0; i < deferred_startup_tasks_.size(); ++i)
+    pending_names.insert(deferred_startup_tasks_[i].name);
+
+  size_t next = deferred_startup_tasks_.size();
+  for (size_t i = 0; i < deferred_startup_tasks_.size(); ++i) {
+    const DeferredStartupTask& candidate = deferred_startup_tasks_[i];
+    if (next < deferred_startup_tasks_.size() &&
+        deferred_startup_tasks_[next].priority <= candidate.priority) {
+      continue;
+    }
+    bool ready = true;
+    for (size_t j = 0; j < candidate.dependencies.size(); ++j) {
+      if (pending_names.count(candidate.dependencies[j])) {
+        ready = false;
+        break;
+      }
+    }
+    if (ready)
+      next = i;
+  }
+
+  if (next == deferred_startup_tasks_.size()) {
+    NOTREACHED() << "Cyclic dependency between deferred startup tasks";
+    next = 0;
+  }
+  return next;
+}
+
+void StartupTaskRunnerService::RunNextDeferredStartupTask() {
+  DCHECK(CalledOnValidThread());
+  deferred_startup_task_scheduled_ = false;
+  if (deferred_startup_tasks_.empty())
+    return;
+
+  size_t next = GetNextDeferredStartupTask();
+  DeferredStartupTask task = deferred_startup_tasks_[next];
+  deferred_startup_tasks_.erase(deferred_startup_tasks_.begin() + next);
+  {
+    TRACE_EVENT1("startup", "StartupTaskRunnerService::RunDeferredStartupTask",
+                 "name", task.name);
+    task.task.Run();
+  }
+
+  if (!deferred_startup_tasks_.empty()) {
+    ScheduleNextDeferredStartupTask();
+    return;
+  }
+
+  UMA_HISTOGRAM_TIMES("Startup.DeferredStartupTasksTime",
+                      base::TimeTicks::Now() -
+                          deferred_startup_tasks_start_time_);
+}
+
+void StartupTaskRunnerService::ScheduleNextDeferredStartupTask() {
+  if (deferred_startup_task_scheduled_ || deferred_startup_tasks_.empty())
+    return;
+
+  deferred_startup_task_scheduled_ = true;
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&StartupTaskRunnerService::RunNextDeferredStartupTask,
+                 weak_factory_.GetWeakPtr()));
 }
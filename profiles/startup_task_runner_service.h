@@ -5,9 +5,15 @@
 #ifndef CHROME_BROWSER_PROFILES_STARTUP_TASK_RUNNER_SERVICE_H_
 #define CHROME_BROWSER_PROFILES_STARTUP_TASK_RUNNER_SERVICE_H_
 
+#include <string>
+#include <vector>
+
 #include "base/basictypes.h"
+#include "base/callback.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
 #include "base/threading/non_thread_safe.h"
+#include "base/time/time.h"
 #include "components/keyed_service/core/keyed_service.h"
 
 class Profile;
@@ -17,9 +23,23 @@ class DeferredSequencedTaskRunner;
 }  // namespace base
 
 // This service manages the startup task runners.
+//
+// It also owns the profile's deferred startup tasks: initialization work that
+// is not needed to show the first browser window (typically creating keyed
+// services) and is therefore run on the UI thread only after that window has
+// been shown.
 class StartupTaskRunnerService : public base::NonThreadSafe,
                                  public KeyedService {
  public:
+  // Among the deferred startup tasks whose dependencies have run, tasks with a
+  // higher priority run first. Tasks of equal priority run in the order they
+  // were added.
+  enum DeferredStartupTaskPriority {
+    DEFERRED_STARTUP_TASK_PRIORITY_HIGH,
+    DEFERRED_STARTUP_TASK_PRIORITY_NORMAL,
+    DEFERRED_STARTUP_TASK_PRIORITY_LOW,
+  };
+
   explicit StartupTaskRunnerService(Profile* profile);
   virtual ~StartupTaskRunnerService();
 
@@ -35,10 +55,61 @@ class StartupTaskRunnerService : public base::NonThreadSafe,
   // Starts the task runners that are deferred during start-up.
   void StartDeferredTaskRunners();
 
+  // Adds |task|, identified by |name|, to the deferred startup tasks. |task|
+  // runs on the UI thread after StartDeferredStartupTasks() has been called,
+  // and only once every task named in |dependencies| has run. A dependency on
+  // a task that is not pending is considered satisfied. Tasks are run one per
+  // message loop iteration so that they don't hold up input or painting.
+  // If deferred startup tasks are already running, |task| is queued with the
+  // remaining ones.
+  void AddDeferredStartupTask(const std::string& name,
+                              const std::vector<std::string>& dependencies,
+                              DeferredStartupTaskPriority priority,
+                              const base::Closure& task);
+
+  // Starts running the deferred startup tasks. Called once the first browser
+  // window of the profile has been shown; if that never happens, this is
+  // called after a delay from StartDeferredTaskRunners(). Subsequent calls
+  // are ignored.
+  void StartDeferredStartupTasks();
+
+  // Returns whether deferred startup tasks are being run or have been run.
+  bool deferred_startup_tasks_started() const {
+    return deferred_startup_tasks_started_;
+  }
+
  private:
+  struct DeferredStartupTask {
+    DeferredStartupTask();
+    ~DeferredStartupTask();
+
+    std::string name;
+    std::vector<std::string> dependencies;
+    DeferredStartupTaskPriority priority;
+    base::Closure task;
+  };
+
+  // Returns the index in |deferred_startup_tasks_| of the next task to run.
+  size_t GetNextDeferredStartupTask() const;
+
+  // Runs the next deferred startup task and schedules the one after it.
+  void RunNextDeferredStartupTask();
+
+  // Posts RunNextDeferredStartupTask() to the current message loop.
+  void ScheduleNextDeferredStartupTask();
+
   Profile* profile_;
   scoped_refptr<base::DeferredSequencedTaskRunner> bookmark_task_runner_;
 
+  // Pending deferred startup tasks, in the order they were added.
+  std::vector<DeferredStartupTask> deferred_startup_tasks_;
+
+  bool deferred_startup_tasks_started_;
+  bool deferred_startup_task_scheduled_;
+  base::TimeTicks deferred_startup_tasks_start_time_;
+
+  base::WeakPtrFactory<StartupTaskRunnerService> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(StartupTaskRunnerService);
 };
 
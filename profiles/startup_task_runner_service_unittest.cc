@@ -0,0 +1,104 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/profiles/startup_task_runner_service.h"
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+void AppendName(std::vector<std::string>* order, const std::string& name) {
+  order->push_back(name);
+}
+
+class StartupTaskRunnerServiceTest : public testing::Test {
+ protected:
+  StartupTaskRunnerServiceTest() : service_(NULL) {}
+
+  void AddTask(const std::string& name,
+               const std::vector<std::string>& dependencies,
+               StartupTaskRunnerService::DeferredStartupTaskPriority priority) {
+    service_.AddDeferredStartupTask(
+        name, dependencies, priority, base::Bind(&AppendName, &order_, name));
+  }
+
+  void AddTask(const std::string& name,
+               StartupTaskRunnerService::DeferredStartupTaskPriority priority) {
+    AddTask(name, std::vector<std::string>(), priority);
+  }
+
+  base::MessageLoop message_loop_;
+  StartupTaskRunnerService service_;
+  std::vector<std::string> order_;
+};
+
+}  // namespace
+
+TEST_F(StartupTaskRunnerServiceTest, NotRunBeforeStart) {
+  AddTask("a", StartupTaskRunnerService::DEFERRED_STARTUP_TASK_PRIORITY_HIGH);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(order_.empty());
+  EXPECT_FALSE(service_.deferred_startup_tasks_started());
+
+  service_.StartDeferredStartupTasks();
+  EXPECT_TRUE(order_.empty());  // Tasks are never run synchronously.
+  base::RunLoop().RunUntilIdle();
+  ASSERT_EQ(1u, order_.size());
+  EXPECT_EQ("a", order_[0]);
+}
+
+TEST_F(StartupTaskRunnerServiceTest, PriorityOrder) {
+  AddTask("low", StartupTaskRunnerService::DEFERRED_STARTUP_TASK_PRIORITY_LOW);
+  AddTask("normal1",
+          StartupTaskRunnerService::DEFERRED_STARTUP_TASK_PRIORITY_NORMAL);
+  AddTask("high", StartupTaskRunnerService::DEFERRED_STARTUP_TASK_PRIORITY_HIGH);
+  AddTask("normal2",
+          StartupTaskRunnerService::DEFERRED_STARTUP_TASK_PRIORITY_NORMAL);
+  service_.StartDeferredStartupTasks();
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_EQ(4u, order_.size());
+  EXPECT_EQ("high", order_[0]);
+  EXPECT_EQ("normal1", order_[1]);
+  EXPECT_EQ("normal2", order_[2]);
+  EXPECT_EQ("low", order_[3]);
+}
+
+TEST_F(StartupTaskRunnerServiceTest, DependenciesRunFirst) {
+  std::vector<std::string> depends_on_b(1, "b");
+  std::vector<std::string> depends_on_c(1, "c");
+  AddTask("a", depends_on_b,
+          StartupTaskRunnerService::DEFERRED_STARTUP_TASK_PRIORITY_HIGH);
+  AddTask("b", depends_on_c,
+          StartupTaskRunnerService::DEFERRED_STARTUP_TASK_PRIORITY_NORMAL);
+  AddTask("c", StartupTaskRunnerService::DEFERRED_STARTUP_TASK_PRIORITY_LOW);
+  // A dependency on an unknown task does not block "d".
+  AddTask("d", std::vector<std::string>(1, "unknown"),
+          StartupTaskRunnerService::DEFERRED_STARTUP_TASK_PRIORITY_LOW);
+  service_.StartDeferredStartupTasks();
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_EQ(4u, order_.size());
+  EXPECT_EQ("c", order_[0]);
+  EXPECT_EQ("b", order_[1]);
+  EXPECT_EQ("a", order_[2]);
+  EXPECT_EQ("d", order_[3]);
+}
+
+TEST_F(StartupTaskRunnerServiceTest, AddAfterStart) {
+  service_.StartDeferredStartupTasks();
+  base::RunLoop().RunUntilIdle();
+  AddTask("late",
+          StartupTaskRunnerService::DEFERRED_STARTUP_TASK_PRIORITY_NORMAL);
+  EXPECT_TRUE(order_.empty());
+  base::RunLoop().RunUntilIdle();
+  ASSERT_EQ(1u, order_.size());
+  EXPECT_EQ("late", order_[0]);
+}
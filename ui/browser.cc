@@ -67,6 +67,8 @@
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/browser/profiles/profile_destroyer.h"
 #include "chrome/browser/profiles/profile_metrics.h"
+#include "chrome/browser/profiles/startup_task_runner_service.h"
+#include "chrome/browser/profiles/startup_task_runner_service_factory.h"
 #include "chrome/browser/repost_form_warning_controller.h"
 #include "chrome/browser/search/search.h"
 #include "chrome/browser/sessions/session_service.h"
@@ -1248,6 +1250,11 @@ void Browser::OnWindowDidShow() {
   }
 #endif  // defined(OS_MACOSX) || defined(OS_WIN) || defined(OS_LINUX)
 
+  // Initialization that was deferred until the profile had a visible window
+  // can start now.
+  StartupTaskRunnerServiceFactory::GetForProfile(
+      profile()->GetOriginalProfile())->StartDeferredStartupTasks();
+
   // Nothing to do for non-tabbed windows.
   if (!is_type_tabbed())
     return;
@@ -449,7 +449,9 @@ BookmarkBarView::BookmarkBarView(Browser* browser, BrowserView* browser_view)
       infobar_visible_(false),
       throbbing_view_(NULL),
       bookmark_bar_state_(BookmarkBar::SHOW),
-      animating_detached_(false) {
+      animating_detached_(false),
+      bookmark_bar_changed_during_extensive_changes_(false),
+      bookmark_bar_child_count_before_extensive_changes_(0) {
   set_id(VIEW_ID_BOOKMARK_BAR);
   Init();
 
@@ -1017,6 +1019,10 @@ void BookmarkBarView::BookmarkNodeMoved(BookmarkModel* model,
                                         int old_index,
                                         const BookmarkNode* new_parent,
                                         int new_index) {
+  if (model->IsDoingExtensiveChanges()) {
+    bookmark_bar_changed_during_extensive_changes_ = true;
+    return;
+  }
   bool was_throbbing = throbbing_view_ &&
       throbbing_view_ == DetermineViewToThrobFromRemove(old_parent, old_index);
   if (was_throbbing)
@@ -1030,6 +1036,10 @@ void BookmarkBarView::BookmarkNodeMoved(BookmarkModel* model,
 void BookmarkBarView::BookmarkNodeAdded(BookmarkModel* model,
                                         const BookmarkNode* parent,
                                         int index) {
+  if (model->IsDoingExtensiveChanges()) {
+    bookmark_bar_changed_during_extensive_changes_ = true;
+    return;
+  }
   BookmarkNodeAddedImpl(model, parent, index);
 }
 
@@ -1041,6 +1051,10 @@ void BookmarkBarView::BookmarkNodeRemoved(BookmarkModel* model,
   // Close the menu if the menu is showing for the deleted node.
   if (bookmark_menu_ && bookmark_menu_->node() == node)
     bookmark_menu_->Cancel();
+  if (model->IsDoingExtensiveChanges()) {
+    bookmark_bar_changed_during_extensive_changes_ = true;
+    return;
+  }
   BookmarkNodeRemovedImpl(model, parent, old_index);
 }
 
@@ -1062,6 +1076,10 @@ void BookmarkBarView::BookmarkAllNodesRemoved(
 
 void BookmarkBarView::BookmarkNodeChanged(BookmarkModel* model,
                                           const BookmarkNode* node) {
+  if (model->IsDoingExtensiveChanges()) {
+    bookmark_bar_changed_during_extensive_changes_ = true;
+    return;
+  }
   BookmarkNodeChangedImpl(model, node);
 }
 
@@ -1070,27 +1088,52 @@ void BookmarkBarView::BookmarkNodeChildrenReordered(BookmarkModel* model,
   if (node != model_->bookmark_bar_node())
     return;  // We only care about reordering of the bookmark bar node.
 
-  // Remove the existing buttons.
-  while (GetBookmarkButtonCount()) {
-    views::View* button = child_at(0);
-    RemoveChildView(button);
-    base::MessageLoop::current()->DeleteSoon(FROM_HERE, button);
+  if (model->IsDoingExtensiveChanges()) {
+    bookmark_bar_changed_during_extensive_changes_ = true;
+    return;
   }
-
-  // Create the new buttons.
-  for (int i = 0, child_count = node->child_count(); i < child_count; ++i)
-    AddChildViewAt(CreateBookmarkButton(node->GetChild(i)), i);
-  UpdateColors();
-
-  Layout();
-  SchedulePaint();
+  RebuildBookmarkButtons();
 }
 
 void BookmarkBarView::BookmarkNodeFaviconChanged(BookmarkModel* model,
                                                  const BookmarkNode* node) {
+  if (model->IsDoingExtensiveChanges()) {
+    bookmark_bar_changed_during_extensive_changes_ = true;
+    return;
+  }
   BookmarkNodeChangedImpl(model, node);
 }
 
+void BookmarkBarView::ExtensiveBookmarkChangesBeginning(BookmarkModel* model) {
+  bookmark_bar_changed_during_extensive_changes_ = false;
+  bookmark_bar_child_count_before_extensive_changes_ =
+      model_->loaded() ? model_->bookmark_bar_node()->child_count() : 0;
+}
+
+void BookmarkBarView::ExtensiveBookmarkChangesEnded(BookmarkModel* model) {
+  if (!bookmark_bar_changed_during_extensive_changes_)
+    return;
+  bookmark_bar_changed_during_extensive_changes_ = false;
+
+  StopThrobbing(true);
+  // RebuildBookmarkButtons() lays out once for both changes.
+  UpdateOtherBookmarksButtonVisibility();
+  RebuildBookmarkButtons();
+
+  // Like BookmarkNodeAddedImpl(), point at the new bookmarks while sync is
+  // merging them in for the first time.
+  const BookmarkNode* bookmark_bar_node = model_->bookmark_bar_node();
+  ProfileSyncService* sync_service(ProfileSyncServiceFactory::
+      GetInstance()->GetForProfile(browser_->profile()));
+  if (bookmark_bar_node->child_count() >
+          bookmark_bar_child_count_before_extensive_changes_ &&
+      sync_service && sync_service->FirstSetupInProgress()) {
+    StartThrobbing(
+        bookmark_bar_node->GetChild(bookmark_bar_node->child_count() - 1),
+        true);
+  }
+}
+
 void BookmarkBarView::WriteDragDataForView(View* sender,
                                            const gfx::Point& press_pt,
                                            ui::OSExchangeData* data) {
@@ -1420,6 +1463,25 @@ void BookmarkBarView::ConfigureButton(const BookmarkNode* node,
   button->set_max_width(kMaxButtonWidth);
 }
 
+void BookmarkBarView::RebuildBookmarkButtons() {
+  // Remove the existing buttons. They are deleted later since this may be
+  // called while one of them is handling an event.
+  while (GetBookmarkButtonCount()) {
+    views::View* button = child_at(0);
+    RemoveChildView(button);
+    base::MessageLoop::current()->DeleteSoon(FROM_HERE, button);
+  }
+
+  // Create the new buttons.
+  const BookmarkNode* node = model_->bookmark_bar_node();
+  for (int i = 0, child_count = node->child_count(); i < child_count; ++i)
+    AddChildViewAt(CreateBookmarkButton(node->GetChild(i)), i);
+  UpdateColors();
+
+  Layout();
+  SchedulePaint();
+}
+
 void BookmarkBarView::BookmarkNodeAddedImpl(BookmarkModel* model,
                                             const BookmarkNode* parent,
                                             int index) {
@@ -1708,13 +1770,19 @@ void BookmarkBarView::UpdateColors() {
 }
 
 void BookmarkBarView::UpdateOtherBookmarksVisibility() {
+  if (!UpdateOtherBookmarksButtonVisibility())
+    return;
+  Layout();
+  SchedulePaint();
+}
+
+bool BookmarkBarView::UpdateOtherBookmarksButtonVisibility() {
   bool has_other_children = !model_->other_node()->empty();
   if (has_other_children == other_bookmarked_button_->visible())
-    return;
+    return false;
   other_bookmarked_button_->SetVisible(has_other_children);
   UpdateBookmarksSeparatorVisibility();
-  Layout();
-  SchedulePaint();
+  return true;
 }
 
 void BookmarkBarView::UpdateBookmarksSeparatorVisibility() {
@@ -228,6 +228,8 @@ class BookmarkBarView : public DetachableToolbarView,
                                              const BookmarkNode* node) OVERRIDE;
   virtual void BookmarkNodeFaviconChanged(BookmarkModel* model,
                                           const BookmarkNode* node) OVERRIDE;
+  virtual void ExtensiveBookmarkChangesBeginning(BookmarkModel* model) OVERRIDE;
+  virtual void ExtensiveBookmarkChangesEnded(BookmarkModel* model) OVERRIDE;
 
   // views::DragController:
   virtual void WriteDragDataForView(views::View* sender,
@@ -263,6 +265,8 @@ class BookmarkBarView : public DetachableToolbarView,
                            ManagedShowAppsShortcutInBookmarksBar);
   FRIEND_TEST_ALL_PREFIXES(BookmarkBarViewInstantExtendedTest,
                            AppsShortcutVisibility);
+  FRIEND_TEST_ALL_PREFIXES(BookmarkBarViewExtensiveChangesTest,
+                           SingleLayoutForBulkImport);
 
   // Used to identify what the user is dropping onto.
   enum DropButtonType {
@@ -362,10 +366,18 @@ class BookmarkBarView : public DetachableToolbarView,
   // Updates the colors for all the child objects in the bookmarks bar.
   void UpdateColors();
 
+  // Replaces the bookmark buttons with new ones for the current children of
+  // the bookmark bar node, then lays out once.
+  void RebuildBookmarkButtons();
+
   // Updates the visibility of |other_bookmarked_button_|. Also shows or hide
   // the separator if required.
   void UpdateOtherBookmarksVisibility();
 
+  // Like UpdateOtherBookmarksVisibility(), but leaves laying out and painting
+  // to the caller. Returns true if the visibility changed.
+  bool UpdateOtherBookmarksButtonVisibility();
+
   // Updates the visibility of |bookmarks_separator_view_|.
   void UpdateBookmarksSeparatorVisibility();
 
@@ -438,6 +450,15 @@ class BookmarkBarView : public DetachableToolbarView,
   // Are we animating to or from the detached state?
   bool animating_detached_;
 
+  // While the model is doing extensive changes, individual changes are not
+  // applied to the buttons. Instead they are rebuilt once the changes end, if
+  // this is true.
+  bool bookmark_bar_changed_during_extensive_changes_;
+
+  // Number of children of the bookmark bar node when the extensive changes
+  // began.
+  int bookmark_bar_child_count_before_extensive_changes_;
+
   DISALLOW_COPY_AND_ASSIGN(BookmarkBarView);
 };
 
@@ -5,6 +5,8 @@
 #include "chrome/browser/ui/views/bookmarks/bookmark_bar_view.h"
 
 #include "base/prefs/pref_service.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
 #include "base/values.h"
 #include "chrome/browser/bookmarks/bookmark_model_factory.h"
 #include "chrome/browser/profiles/profile.h"
@@ -17,6 +19,7 @@
 #include "chrome/test/base/scoped_testing_local_state.h"
 #include "chrome/test/base/testing_browser_process.h"
 #include "chrome/test/base/testing_pref_service_syncable.h"
+#include "components/bookmarks/browser/bookmark_model.h"
 #include "components/bookmarks/test/bookmark_test_helpers.h"
 #include "ui/views/controls/button/text_button.h"
 
@@ -103,3 +106,70 @@ TEST_F(BookmarkBarViewTest, ManagedShowAppsShortcutInBookmarksBar) {
   EXPECT_TRUE(bookmark_bar_view.apps_page_shortcut_->visible());
 }
 #endif
+
+namespace {
+
+// A BookmarkBarView that counts its layout passes.
+class LayoutCountingBookmarkBarView : public BookmarkBarView {
+ public:
+  explicit LayoutCountingBookmarkBarView(Browser* browser)
+      : BookmarkBarView(browser, NULL),
+        layout_count_(0) {
+  }
+
+  int layout_count() const { return layout_count_; }
+  void reset_layout_count() { layout_count_ = 0; }
+
+  // BookmarkBarView:
+  virtual void Layout() OVERRIDE {
+    ++layout_count_;
+    BookmarkBarView::Layout();
+  }
+
+ private:
+  int layout_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(LayoutCountingBookmarkBarView);
+};
+
+}  // namespace
+
+typedef BrowserWithTestWindowTest BookmarkBarViewExtensiveChangesTest;
+
+// Verifies that importing many bookmarks as extensive changes lays out the
+// bookmark bar once, when the changes end.
+TEST_F(BookmarkBarViewExtensiveChangesTest, SingleLayoutForBulkImport) {
+  const int kNodeCount = 10000;
+  ScopedTestingLocalState local_state(TestingBrowserProcess::GetGlobal());
+  profile()->CreateBookmarkModel(true);
+  BookmarkModel* model = BookmarkModelFactory::GetForProfile(profile());
+  test::WaitForBookmarkModelToLoad(model);
+  LayoutCountingBookmarkBarView bookmark_bar_view(browser());
+  bookmark_bar_view.set_owned_by_client();
+  bookmark_bar_view.reset_layout_count();
+
+  model->BeginExtensiveChanges();
+  for (int i = 0; i < kNodeCount; ++i) {
+    const BookmarkNode* parent = (i % 2) ? model->other_node() :
+                                           model->bookmark_bar_node();
+    model->AddURL(parent, parent->child_count(),
+                  base::ASCIIToUTF16("bookmark " + base::IntToString(i)),
+                  GURL("http://example.com/" + base::IntToString(i)));
+  }
+  EXPECT_EQ(0, bookmark_bar_view.layout_count());
+  EXPECT_FALSE(bookmark_bar_view.other_bookmarked_button()->visible());
+  model->EndExtensiveChanges();
+
+  // Showing the Other Bookmarks button doesn't cost a layout of its own.
+  EXPECT_TRUE(bookmark_bar_view.other_bookmarked_button()->visible());
+  EXPECT_EQ(1, bookmark_bar_view.layout_count());
+  EXPECT_EQ(kNodeCount / 2,
+            bookmark_bar_view.GetBookmarkButtonCount());
+
+  // Outside of extensive changes, each change is still applied on its own.
+  bookmark_bar_view.reset_layout_count();
+  model->AddURL(model->bookmark_bar_node(), 0, base::ASCIIToUTF16("a"),
+                GURL("http://a.com"));
+  EXPECT_EQ(1, bookmark_bar_view.layout_count());
+  EXPECT_EQ(kNodeCount / 2 + 1, bookmark_bar_view.GetBookmarkButtonCount());
+}
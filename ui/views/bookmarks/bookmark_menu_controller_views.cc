@@ -40,7 +40,8 @@ BookmarkMenuController::BookmarkMenuController(Browser* browser,
       node_(node),
       observer_(NULL),
       for_drop_(false),
-      bookmark_bar_(NULL) {
+      bookmark_bar_(NULL),
+      model_changed_during_extensive_changes_(false) {
   menu_delegate_->Init(this, NULL, node, start_child_index,
                        BookmarkMenuDelegate::HIDE_PERMANENT_FOLDERS,
                        BOOKMARK_LAUNCH_LOCATION_BAR_SUBFOLDER);
@@ -189,10 +190,22 @@ int BookmarkMenuController::GetMaxWidthForMenu(MenuItemView* view) {
 }
 
 void BookmarkMenuController::BookmarkModelChanged() {
+  if (menu_delegate_->GetBookmarkModel()->IsDoingExtensiveChanges()) {
+    model_changed_during_extensive_changes_ = true;
+    return;
+  }
   if (!menu_delegate_->is_mutating_model())
     menu()->Cancel();
 }
 
+void BookmarkMenuController::ExtensiveBookmarkChangesEnded(
+    BookmarkModel* model) {
+  if (!model_changed_during_extensive_changes_)
+    return;
+  model_changed_during_extensive_changes_ = false;
+  BookmarkModelChanged();
+}
+
 BookmarkMenuController::~BookmarkMenuController() {
   menu_delegate_->GetBookmarkModel()->RemoveObserver(this);
   if (observer_)
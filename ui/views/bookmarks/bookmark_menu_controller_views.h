@@ -114,6 +114,7 @@ class BookmarkMenuController : public BaseBookmarkModelObserver,
 
   // BaseBookmarkModelObserver:
   virtual void BookmarkModelChanged() OVERRIDE;
+  virtual void ExtensiveBookmarkChangesEnded(BookmarkModel* model) OVERRIDE;
 
  private:
   // BookmarkMenuController deletes itself as necessary.
@@ -140,6 +141,10 @@ class BookmarkMenuController : public BaseBookmarkModelObserver,
   // been destroyed before the menu.
   BookmarkBarView* bookmark_bar_;
 
+  // True if the model changed while doing extensive changes. The menu is only
+  // cancelled once they end.
+  bool model_changed_during_extensive_changes_;
+
   DISALLOW_COPY_AND_ASSIGN(BookmarkMenuController);
 };
 
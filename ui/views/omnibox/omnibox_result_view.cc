@@ -170,6 +170,15 @@ SkColor OmniboxResultView::GetColor(
 }
 
 void OmniboxResultView::SetMatch(const AutocompleteMatch& match) {
+  // While the user types, most updates of the result only change the
+  // relevance or order of the matches. Keep the laid out text of a row whose
+  // match looks the same.
+  if (AutocompleteMatch::DisplayEqual(match_, match)) {
+    match_ = match;
+    animation_->Reset();
+    return;
+  }
+
   match_ = match;
   ResetRenderTexts();
   animation_->Reset();
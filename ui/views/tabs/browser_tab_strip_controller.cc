@@ -49,6 +49,10 @@ using content::WebContents;
 
 namespace {
 
+// How long tab data changes are coalesced before being pushed to the
+// tabstrip. Roughly one frame at 60Hz.
+const int kTabDataUpdateDelayMs = 16;
+
 TabRendererData::NetworkState TabContentsNetworkState(
     WebContents* contents) {
   if (!contents || !contents->IsLoadingToDifferentDocument())
@@ -436,6 +440,7 @@ void BrowserTabStripController::TabDetachedAt(WebContents* contents,
   // Cancel any pending tab transition.
   hover_tab_selector_.CancelTabTransition();
 
+  pending_tab_data_updates_.erase(contents);
   tabstrip_->RemoveTabAt(model_index);
 }
 
@@ -466,13 +471,14 @@ void BrowserTabStripController::TabChangedAt(WebContents* contents,
     return;
   }
 
-  SetTabDataAt(contents, model_index);
+  ScheduleTabDataUpdate(contents, model_index);
 }
 
 void BrowserTabStripController::TabReplacedAt(TabStripModel* tab_strip_model,
                                               WebContents* old_contents,
                                               WebContents* new_contents,
                                               int model_index) {
+  pending_tab_data_updates_.erase(old_contents);
   SetTabDataAt(new_contents, model_index);
 }
 
@@ -515,11 +521,64 @@ void BrowserTabStripController::SetTabRendererDataFromModel(
 
 void BrowserTabStripController::SetTabDataAt(content::WebContents* web_contents,
                                              int model_index) {
+  // The tab is brought up to date here, so any queued update is redundant.
+  pending_tab_data_updates_.erase(web_contents);
+
   TabRendererData data;
   SetTabRendererDataFromModel(web_contents, model_index, &data, EXISTING_TAB);
   tabstrip_->SetTabData(model_index, data);
 }
 
+void BrowserTabStripController::ScheduleTabDataUpdate(
+    content::WebContents* web_contents,
+    int model_index) {
+  if (tab_data_update_timer_.IsRunning()) {
+    pending_tab_data_updates_.insert(web_contents);
+    return;
+  }
+
+  // Nothing was updated recently, so apply this one right away and only
+  // start queueing if more updates follow within the window.
+  SetTabDataAt(web_contents, model_index);
+  StartTabDataUpdateTimer();
+}
+
+void BrowserTabStripController::StartTabDataUpdateTimer() {
+  tab_data_update_timer_.Start(
+      FROM_HERE,
+      base::TimeDelta::FromMilliseconds(kTabDataUpdateDelayMs),
+      this,
+      &BrowserTabStripController::FlushPendingTabDataUpdates);
+}
+
+void BrowserTabStripController::FlushPendingTabDataUpdates() {
+  tab_data_update_timer_.Stop();
+  if (pending_tab_data_updates_.empty())
+    return;
+
+  // Indices may have shifted since the updates were queued, so resolve them
+  // against the model now.
+  TabStrip::TabDataBatch batch;
+  batch.reserve(pending_tab_data_updates_.size());
+  for (std::set<WebContents*>::const_iterator i =
+           pending_tab_data_updates_.begin();
+       i != pending_tab_data_updates_.end(); ++i) {
+    int model_index = model_->GetIndexOfWebContents(*i);
+    if (model_index == TabStripModel::kNoTab)
+      continue;
+    batch.push_back(std::make_pair(model_index, TabRendererData()));
+    SetTabRendererDataFromModel(*i, model_index, &batch.back().second,
+                                EXISTING_TAB);
+  }
+  pending_tab_data_updates_.clear();
+
+  tabstrip_->SetTabDataBatch(batch);
+
+  // Still inside a burst; keep queueing until a window passes without
+  // updates.
+  StartTabDataUpdateTimer();
+}
+
 void BrowserTabStripController::StartHighlightTabsForCommand(
     TabStripModel::ContextMenuCommand command_id,
     Tab* tab) {
@@ -5,9 +5,12 @@
 #ifndef CHROME_BROWSER_UI_VIEWS_TABS_BROWSER_TAB_STRIP_CONTROLLER_H_
 #define CHROME_BROWSER_UI_VIEWS_TABS_BROWSER_TAB_STRIP_CONTROLLER_H_
 
+#include <set>
+
 #include "base/compiler_specific.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/prefs/pref_change_registrar.h"
+#include "base/timer/timer.h"
 #include "chrome/browser/ui/tabs/hover_tab_selector.h"
 #include "chrome/browser/ui/tabs/tab_strip_model.h"
 #include "chrome/browser/ui/views/frame/immersive_mode_controller.h"
@@ -122,11 +125,27 @@ class BrowserTabStripController : public TabStripController,
   const Browser* browser() const { return browser_; }
 
  private:
+  friend class BrowserTabStripControllerTest;
+
   class TabContextMenuContents;
 
   // Invokes tabstrip_->SetTabData.
   void SetTabDataAt(content::WebContents* web_contents, int model_index);
 
+  // Updates the tab for |web_contents| immediately if no update happened
+  // recently, otherwise queues it for a deferred SetTabData. Favicon, title
+  // and loading state changes arrive one tab at a time (hundreds of them
+  // during session restore); queued updates are pushed to the tabstrip
+  // together roughly once per frame.
+  void ScheduleTabDataUpdate(content::WebContents* web_contents,
+                             int model_index);
+
+  // Starts the window during which further tab data updates are queued.
+  void StartTabDataUpdateTimer();
+
+  // Pushes all queued tab data updates to the tabstrip in a single batch.
+  void FlushPendingTabDataUpdates();
+
   void StartHighlightTabsForCommand(
       TabStripModel::ContextMenuCommand command_id,
       Tab* tab);
@@ -165,6 +184,11 @@ class BrowserTabStripController : public TabStripController,
 
   PrefChangeRegistrar local_pref_registrar_;
 
+  // WebContents whose TabRendererData has changed but hasn't yet been pushed
+  // to the tabstrip, and the timer that flushes them.
+  std::set<content::WebContents*> pending_tab_data_updates_;
+  base::OneShotTimer<BrowserTabStripController> tab_data_update_timer_;
+
   base::WeakPtrFactory<BrowserTabStripController> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(BrowserTabStripController);
@@ -0,0 +1,129 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/ui/views/tabs/browser_tab_strip_controller.h"
+
+#include "base/memory/scoped_ptr.h"
+#include "chrome/browser/ui/browser.h"
+#include "chrome/browser/ui/tabs/tab_strip_model.h"
+#include "chrome/browser/ui/tabs/tab_strip_model_observer.h"
+#include "chrome/browser/ui/views/tabs/tab.h"
+#include "chrome/browser/ui/views/tabs/tab_renderer_data.h"
+#include "chrome/browser/ui/views/tabs/tab_strip.h"
+#include "chrome/test/base/browser_with_test_window_test.h"
+#include "chrome/test/base/scoped_testing_local_state.h"
+#include "chrome/test/base/testing_browser_process.h"
+#include "content/public/browser/web_contents.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+class BrowserTabStripControllerTest : public BrowserWithTestWindowTest {
+ public:
+  BrowserTabStripControllerTest()
+      : local_state_(TestingBrowserProcess::GetGlobal()),
+        controller_(NULL) {
+  }
+
+  virtual void SetUp() OVERRIDE {
+    BrowserWithTestWindowTest::SetUp();
+    AddTab(browser(), GURL("http://c.com"));
+    AddTab(browser(), GURL("http://b.com"));
+    AddTab(browser(), GURL("http://a.com"));
+
+    controller_ = new BrowserTabStripController(browser(), model());
+    tab_strip_.reset(new TabStrip(controller_));
+    controller_->InitFromModel(tab_strip_.get());
+    EndBurst();
+  }
+
+  virtual void TearDown() OVERRIDE {
+    // The tabstrip owns the controller, which observes the model.
+    tab_strip_.reset();
+    BrowserWithTestWindowTest::TearDown();
+  }
+
+ protected:
+  TabStripModel* model() { return browser()->tab_strip_model(); }
+
+  GURL TabURL(int index) { return tab_strip_->tab_at(index)->data().url; }
+
+  // Makes the tab at |index| stale, so it is only current again once the
+  // controller has pushed new data for it.
+  void ClearTabData(int index) {
+    tab_strip_->SetTabData(index, TabRendererData());
+  }
+
+  void UpdateTab(int index) {
+    model()->UpdateWebContentsStateAt(index, TabStripModelObserver::ALL);
+  }
+
+  // Runs the pending flush, as the coalescing timer would.
+  void Flush() { controller_->FlushPendingTabDataUpdates(); }
+
+  // Lets the coalescing window lapse, so the next update is isolated again.
+  void EndBurst() {
+    Flush();
+    controller_->tab_data_update_timer_.Stop();
+  }
+
+  bool IsCoalescing() const {
+    return controller_->tab_data_update_timer_.IsRunning();
+  }
+
+ private:
+  ScopedTestingLocalState local_state_;
+  scoped_ptr<TabStrip> tab_strip_;
+  BrowserTabStripController* controller_;
+
+  DISALLOW_COPY_AND_ASSIGN(BrowserTabStripControllerTest);
+};
+
+// An update with none before it reaches the tabstrip without waiting.
+TEST_F(BrowserTabStripControllerTest, IsolatedUpdateIsImmediate) {
+  ClearTabData(1);
+  UpdateTab(1);
+  EXPECT_EQ(GURL("http://b.com"), TabURL(1));
+  EXPECT_TRUE(IsCoalescing());
+
+  // Once the window lapses the next update is immediate again.
+  EndBurst();
+  ClearTabData(0);
+  UpdateTab(0);
+  EXPECT_EQ(GURL("http://a.com"), TabURL(0));
+}
+
+// Updates that follow closely behind another are applied together on flush.
+TEST_F(BrowserTabStripControllerTest, BurstIsBatched) {
+  UpdateTab(0);
+  ClearTabData(1);
+  ClearTabData(2);
+  UpdateTab(1);
+  UpdateTab(2);
+  UpdateTab(1);
+  EXPECT_EQ(GURL(), TabURL(1));
+  EXPECT_EQ(GURL(), TabURL(2));
+
+  Flush();
+  EXPECT_EQ(GURL("http://b.com"), TabURL(1));
+  EXPECT_EQ(GURL("http://c.com"), TabURL(2));
+  // The burst may continue, so updates keep queueing for another window.
+  EXPECT_TRUE(IsCoalescing());
+}
+
+// Queued updates for closed tabs are dropped, and the rest land on the tab's
+// current index.
+TEST_F(BrowserTabStripControllerTest, QueuedUpdateFollowsModelChanges) {
+  UpdateTab(1);
+  ClearTabData(2);
+  UpdateTab(0);
+  UpdateTab(2);
+
+  delete model()->DetachWebContentsAt(0);
+  ASSERT_EQ(2, model()->count());
+  EXPECT_EQ(GURL(), TabURL(1));
+
+  Flush();
+  EXPECT_EQ(GURL("http://b.com"), TabURL(0));
+  EXPECT_EQ(GURL("http://c.com"), TabURL(1));
+}
@@ -705,9 +705,16 @@ void TabStrip::RemoveTabAt(int model_index) {
 }
 
 void TabStrip::SetTabData(int model_index, const TabRendererData& data) {
-  Tab* tab = tab_at(model_index);
-  bool mini_state_changed = tab->data().mini != data.mini;
-  tab->SetData(data);
+  SetTabDataBatch(TabDataBatch(1, std::make_pair(model_index, data)));
+}
+
+void TabStrip::SetTabDataBatch(const TabDataBatch& batch) {
+  bool mini_state_changed = false;
+  for (TabDataBatch::const_iterator i = batch.begin(); i != batch.end(); ++i) {
+    Tab* tab = tab_at(i->first);
+    mini_state_changed |= tab->data().mini != i->second.mini;
+    tab->SetData(i->second);
+  }
 
   if (mini_state_changed) {
     if (touch_layout_.get()) {
@@ -5,6 +5,7 @@
 #ifndef CHROME_BROWSER_UI_VIEWS_TABS_TAB_STRIP_H_
 #define CHROME_BROWSER_UI_VIEWS_TABS_TAB_STRIP_H_
 
+#include <utility>
 #include <vector>
 
 #include "base/compiler_specific.h"
@@ -105,6 +106,12 @@ class TabStrip : public views::View,
   // Sets the tab data at the specified model index.
   void SetTabData(int model_index, const TabRendererData& data);
 
+  // Sets the tab data for a set of tabs at once, as pairs of model index and
+  // data. This is the same as calling SetTabData() for each entry, except that
+  // the tabstrip's layout is updated at most once for the whole batch.
+  typedef std::vector<std::pair<int, TabRendererData> > TabDataBatch;
+  void SetTabDataBatch(const TabDataBatch& batch);
+
   // Invoked from the controller when the close initiates from the TabController
   // (the user clicked the tab close button or middle clicked the tab). This is
   // invoked from Close. Because of unload handlers Close is not always
@@ -5,6 +5,7 @@
 #include "chrome/browser/ui/views/tabs/tab_strip.h"
 
 #include "base/message_loop/message_loop.h"
+#include "base/strings/utf_string_conversions.h"
 #include "chrome/browser/ui/views/tabs/fake_base_tab_strip_controller.h"
 #include "chrome/browser/ui/views/tabs/tab.h"
 #include "chrome/browser/ui/views/tabs/tab_strip.h"
@@ -205,6 +206,28 @@ TEST_F(TabStripTest, RemoveTab) {
   EXPECT_EQ(0, observer.last_tab_removed());
 }
 
+// Verifies SetTabDataBatch applies each entry to the tab at its model index.
+TEST_F(TabStripTest, SetTabDataBatch) {
+  controller_->AddTab(0, false);
+  controller_->AddTab(1, false);
+  controller_->AddTab(2, false);
+
+  TabStrip::TabDataBatch batch;
+  TabRendererData data;
+  data.title = base::ASCIIToUTF16("first");
+  batch.push_back(std::make_pair(0, data));
+  data.title = base::ASCIIToUTF16("last");
+  data.loading = true;
+  batch.push_back(std::make_pair(2, data));
+  tab_strip_->SetTabDataBatch(batch);
+
+  EXPECT_EQ(base::ASCIIToUTF16("first"), tab_strip_->tab_at(0)->data().title);
+  EXPECT_FALSE(tab_strip_->tab_at(0)->data().loading);
+  EXPECT_TRUE(tab_strip_->tab_at(1)->data().title.empty());
+  EXPECT_EQ(base::ASCIIToUTF16("last"), tab_strip_->tab_at(2)->data().title);
+  EXPECT_TRUE(tab_strip_->tab_at(2)->data().loading);
+}
+
 TEST_F(TabStripTest, ImmersiveMode) {
   // Immersive mode defaults to off.
   EXPECT_FALSE(tab_strip_->IsImmersiveStyle());
@@ -44,14 +44,17 @@ void BrowserActionTestUtil::InspectPopup(int index) {
 }
 
 bool BrowserActionTestUtil::HasIcon(int index) {
-  return GetContainer(browser_)->GetBrowserActionViewAt(index)->button()->
-      HasIcon();
+  BrowserActionButton* button =
+      GetContainer(browser_)->GetBrowserActionViewAt(index)->button();
+  button->FlushForTesting();
+  return button->HasIcon();
 }
 
 gfx::Image BrowserActionTestUtil::GetIcon(int index) {
-  gfx::ImageSkia icon = GetContainer(browser_)->GetBrowserActionViewAt(index)->
-      button()->GetIconForTest();
-  return gfx::Image(icon);
+  BrowserActionButton* button =
+      GetContainer(browser_)->GetBrowserActionViewAt(index)->button();
+  button->FlushForTesting();
+  return gfx::Image(button->GetIconForTest());
 }
 
 void BrowserActionTestUtil::Press(int index) {
@@ -66,8 +69,10 @@ std::string BrowserActionTestUtil::GetExtensionId(int index) {
 
 std::string BrowserActionTestUtil::GetTooltip(int index) {
   base::string16 text;
-  GetContainer(browser_)->GetBrowserActionViewAt(index)->button()->
-    GetTooltipText(gfx::Point(), &text);
+  BrowserActionButton* button =
+      GetContainer(browser_)->GetBrowserActionViewAt(index)->button();
+  button->FlushForTesting();
+  button->GetTooltipText(gfx::Point(), &text);
   return base::UTF16ToUTF8(text);
 }
 
@@ -33,6 +33,14 @@
 
 using extensions::Extension;
 
+namespace {
+
+// Minimum interval between repaints caused by the browser action changing.
+// Roughly one frame at 60Hz.
+const int kUpdateThrottleMs = 16;
+
+}  // namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 // BrowserActionView
 
@@ -106,7 +114,8 @@ BrowserActionButton::BrowserActionButton(const Extension* extension,
       delegate_(delegate),
       context_menu_(NULL),
       called_registered_extension_command_(false),
-      icon_observer_(NULL) {
+      icon_observer_(NULL),
+      update_pending_(false) {
   SetBorder(views::Border::NullBorder());
   set_alignment(TextButton::ALIGN_CENTER);
   set_context_menu_controller(this);
@@ -134,6 +143,7 @@ BrowserActionButton::BrowserActionButton(const Extension* extension,
 
 void BrowserActionButton::Destroy() {
   MaybeUnregisterExtensionCommand(false);
+  update_throttle_timer_.Stop();
 
   if (context_menu_) {
     context_menu_->Cancel();
@@ -264,10 +274,7 @@ void BrowserActionButton::Observe(int type,
                                   const content::NotificationDetails& details) {
   switch (type) {
     case chrome::NOTIFICATION_EXTENSION_BROWSER_ACTION_UPDATED:
-      UpdateState();
-      // The browser action may have become visible/hidden so we need to make
-      // sure the state gets updated.
-      delegate_->OnBrowserActionVisibilityChanged();
+      OnBrowserActionUpdated();
       break;
     case chrome::NOTIFICATION_EXTENSION_COMMAND_ADDED:
     case chrome::NOTIFICATION_EXTENSION_COMMAND_REMOVED: {
@@ -392,6 +399,13 @@ gfx::ImageSkia BrowserActionButton::GetIconForTest() {
   return icon();
 }
 
+void BrowserActionButton::FlushForTesting() {
+  if (!update_pending_)
+    return;
+  update_throttle_timer_.Stop();
+  OnUpdateThrottleTimer();
+}
+
 BrowserActionButton::~BrowserActionButton() {
 }
 
@@ -428,3 +442,28 @@ void BrowserActionButton::MaybeUnregisterExtensionCommand(bool only_if_active) {
     keybinding_.reset(NULL);
   }
 }
+
+void BrowserActionButton::OnBrowserActionUpdated() {
+  if (update_throttle_timer_.IsRunning()) {
+    update_pending_ = true;
+    return;
+  }
+
+  UpdateState();
+  // The browser action may have become visible/hidden so we need to make
+  // sure the state gets updated.
+  delegate_->OnBrowserActionVisibilityChanged();
+
+  update_throttle_timer_.Start(
+      FROM_HERE,
+      base::TimeDelta::FromMilliseconds(kUpdateThrottleMs),
+      this,
+      &BrowserActionButton::OnUpdateThrottleTimer);
+}
+
+void BrowserActionButton::OnUpdateThrottleTimer() {
+  if (!update_pending_)
+    return;
+  update_pending_ = false;
+  OnBrowserActionUpdated();
+}
@@ -7,6 +7,7 @@
 
 #include <string>
 
+#include "base/timer/timer.h"
 #include "chrome/browser/extensions/extension_action_icon_factory.h"
 #include "chrome/browser/extensions/extension_context_menu_model.h"
 #include "content/public/browser/notification_observer.h"
@@ -195,6 +196,10 @@ class BrowserActionButton : public views::MenuButton,
   // Returns button icon so it can be accessed during tests.
   gfx::ImageSkia GetIconForTest();
 
+  // Applies a throttled update right away, so tests can observe the state
+  // without waiting for the timer.
+  void FlushForTesting();
+
  protected:
   // Overridden from views::View:
   virtual void ViewHierarchyChanged(
@@ -210,6 +215,12 @@ class BrowserActionButton : public views::MenuButton,
   // it is active.
   void MaybeUnregisterExtensionCommand(bool only_if_active);
 
+  // Called when the browser action's state changes. The first change updates
+  // the button right away; further changes within the same frame are folded
+  // into a single update when |update_throttle_timer_| fires.
+  void OnBrowserActionUpdated();
+  void OnUpdateThrottleTimer();
+
   // The Browser object this button is associated with.
   Browser* browser_;
 
@@ -249,6 +260,12 @@ class BrowserActionButton : public views::MenuButton,
   // updated.
   IconObserver* icon_observer_;
 
+  // Paces updates from extensions that change their icon or badge many times
+  // per second. |update_pending_| is set if a change arrived while the timer
+  // was running.
+  base::OneShotTimer<BrowserActionButton> update_throttle_timer_;
+  bool update_pending_;
+
   friend class base::DeleteHelper<BrowserActionButton>;
 
   DISALLOW_COPY_AND_ASSIGN(BrowserActionButton);
@@ -917,7 +917,8 @@ WrenchMenu::WrenchMenu(Browser* browser,
       bookmark_menu_(NULL),
       feedback_menu_item_(NULL),
       use_new_menu_(use_new_menu),
-      supports_new_separators_(supports_new_separators) {
+      supports_new_separators_(supports_new_separators),
+      bookmark_model_changed_during_extensive_changes_(false) {
   registrar_.Add(this, chrome::NOTIFICATION_GLOBAL_ERRORS_CHANGED,
                  content::Source<Profile>(browser_->profile()));
 }
@@ -1192,10 +1193,21 @@ void WrenchMenu::WillHideMenu(MenuItemView* menu) {
 
 void WrenchMenu::BookmarkModelChanged() {
   DCHECK(bookmark_menu_delegate_.get());
+  if (bookmark_menu_delegate_->GetBookmarkModel()->IsDoingExtensiveChanges()) {
+    bookmark_model_changed_during_extensive_changes_ = true;
+    return;
+  }
   if (!bookmark_menu_delegate_->is_mutating_model())
     root_->Cancel();
 }
 
+void WrenchMenu::ExtensiveBookmarkChangesEnded(BookmarkModel* model) {
+  if (!bookmark_model_changed_during_extensive_changes_)
+    return;
+  bookmark_model_changed_during_extensive_changes_ = false;
+  BookmarkModelChanged();
+}
+
 void WrenchMenu::Observe(int type,
                          const content::NotificationSource& source,
                          const content::NotificationDetails& details) {
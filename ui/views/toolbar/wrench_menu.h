@@ -98,6 +98,7 @@ class WrenchMenu : public views::MenuDelegate,
 
   // BaseBookmarkModelObserver overrides:
   virtual void BookmarkModelChanged() OVERRIDE;
+  virtual void ExtensiveBookmarkChangesEnded(BookmarkModel* model) OVERRIDE;
 
   // content::NotificationObserver overrides:
   virtual void Observe(int type,
@@ -184,6 +185,10 @@ class WrenchMenu : public views::MenuDelegate,
 
   const bool supports_new_separators_;
 
+  // True if the bookmark model changed while doing extensive changes. The
+  // menu is only cancelled once they end.
+  bool bookmark_model_changed_during_extensive_changes_;
+
   ObserverList<WrenchMenuObserver> observer_list_;
 
   DISALLOW_COPY_AND_ASSIGN(WrenchMenu);
@@ -50,7 +50,7 @@ class PowerMessageHandler : public content::WebUIMessageHandler {
   void OnGetCpuIdleData(const base::ListValue* value);
   void OnGetCpuFreqData(const base::ListValue* value);
   void GetJsStateOccupancyData(
-      const std::vector<CpuDataCollector::StateOccupancySampleDeque>& data,
+      const std::vector<CpuDataCollector::StateOccupancySampleBuffer>& data,
       const std::vector<std::string>& state_names,
       base::ListValue* js_data);
   void GetJsSystemResumedData(base::ListValue* value);
@@ -104,7 +104,7 @@ void PowerMessageHandler::OnGetCpuIdleData(const base::ListValue* value) {
   const CpuDataCollector& cpu_data_collector =
       PowerDataCollector::Get()->cpu_data_collector();
 
-  const std::vector<CpuDataCollector::StateOccupancySampleDeque>& idle_data =
+  const std::vector<CpuDataCollector::StateOccupancySampleBuffer>& idle_data =
       cpu_data_collector.cpu_idle_state_data();
   const std::vector<std::string>& idle_state_names =
       cpu_data_collector.cpu_idle_state_names();
@@ -123,7 +123,7 @@ void PowerMessageHandler::OnGetCpuFreqData(const base::ListValue* value) {
   const CpuDataCollector& cpu_data_collector =
       PowerDataCollector::Get()->cpu_data_collector();
 
-  const std::vector<CpuDataCollector::StateOccupancySampleDeque>& freq_data =
+  const std::vector<CpuDataCollector::StateOccupancySampleBuffer>& freq_data =
       cpu_data_collector.cpu_freq_state_data();
   const std::vector<std::string>& freq_state_names =
       cpu_data_collector.cpu_freq_state_names();
@@ -155,14 +155,14 @@ void PowerMessageHandler::GetJsSystemResumedData(base::ListValue *data) {
 }
 
 void PowerMessageHandler::GetJsStateOccupancyData(
-    const std::vector<CpuDataCollector::StateOccupancySampleDeque>& data,
+    const std::vector<CpuDataCollector::StateOccupancySampleBuffer>& data,
     const std::vector<std::string>& state_names,
     base::ListValue *js_data) {
   for (unsigned int cpu = 0; cpu < data.size(); ++cpu) {
-    const CpuDataCollector::StateOccupancySampleDeque& sample_deque = data[cpu];
+    const CpuDataCollector::StateOccupancySampleBuffer& samples = data[cpu];
     scoped_ptr<base::ListValue> js_sample_list(new base::ListValue);
-    for (unsigned int i = 0; i < sample_deque.size(); ++i) {
-      const CpuDataCollector::StateOccupancySample& sample = sample_deque[i];
+    for (unsigned int i = 0; i < samples.size(); ++i) {
+      const CpuDataCollector::StateOccupancySample& sample = samples[i];
       scoped_ptr<base::DictionaryValue> js_sample(new base::DictionaryValue);
       js_sample->SetDouble("time", sample.time.ToJsTime());
       js_sample->SetBoolean("cpuOnline", sample.cpu_online);
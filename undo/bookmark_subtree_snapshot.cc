@@ -0,0 +1,151 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/undo/bookmark_subtree_snapshot.h"
+
+#include "base/containers/hash_tables.h"
+#include "base/logging.h"
+#include "base/time/time.h"
+#include "components/bookmarks/browser/bookmark_node.h"
+#include "url/gurl.h"
+
+// BookmarkSubtreeSnapshot::Builder -------------------------------------------
+
+// Walks a bookmark subtree and appends it to a snapshot, interning strings as
+// it goes. The interning tables only live for the duration of the walk.
+class BookmarkSubtreeSnapshot::Builder {
+ public:
+  explicit Builder(BookmarkSubtreeSnapshot* snapshot) : snapshot_(snapshot) {}
+
+  void AddNode(const BookmarkNode* node);
+
+ private:
+  StringRef InternString(const std::string& value);
+  StringRef InternTitle(const base::string16& value);
+
+  BookmarkSubtreeSnapshot* snapshot_;
+  base::hash_map<std::string, StringRef> strings_;
+  base::hash_map<base::string16, StringRef> titles_;
+
+  DISALLOW_COPY_AND_ASSIGN(Builder);
+};
+
+void BookmarkSubtreeSnapshot::Builder::AddNode(const BookmarkNode* node) {
+  Node snapshot_node;
+  snapshot_node.id = node->id();
+  snapshot_node.date_added = node->date_added().ToInternalValue();
+  snapshot_node.date_folder_modified =
+      node->date_folder_modified().ToInternalValue();
+  snapshot_node.title = InternTitle(node->GetTitle());
+  snapshot_node.is_url = node->is_url();
+  snapshot_node.url = InternString(
+      node->is_url() ? node->url().spec() : std::string());
+  snapshot_node.meta_info_begin = snapshot_->meta_info_.size();
+  snapshot_node.meta_info_count = 0;
+  const BookmarkNode::MetaInfoMap* meta_info = node->GetMetaInfoMap();
+  if (meta_info) {
+    for (BookmarkNode::MetaInfoMap::const_iterator it = meta_info->begin();
+         it != meta_info->end(); ++it) {
+      snapshot_->meta_info_.push_back(
+          std::make_pair(InternString(it->first), InternString(it->second)));
+    }
+    snapshot_node.meta_info_count = meta_info->size();
+  }
+  snapshot_node.child_count = node->is_url() ? 0 : node->child_count();
+  snapshot_->nodes_.push_back(snapshot_node);
+
+  for (int i = 0; i < snapshot_node.child_count; ++i)
+    AddNode(node->GetChild(i));
+}
+
+BookmarkSubtreeSnapshot::StringRef
+BookmarkSubtreeSnapshot::Builder::InternString(const std::string& value) {
+  std::pair<base::hash_map<std::string, StringRef>::iterator, bool> result =
+      strings_.insert(std::make_pair(value, StringRef()));
+  if (result.second) {
+    result.first->second.offset = snapshot_->chars_.size();
+    result.first->second.length = value.size();
+    snapshot_->chars_.append(value);
+  }
+  return result.first->second;
+}
+
+BookmarkSubtreeSnapshot::StringRef
+BookmarkSubtreeSnapshot::Builder::InternTitle(const base::string16& value) {
+  std::pair<base::hash_map<base::string16, StringRef>::iterator, bool> result =
+      titles_.insert(std::make_pair(value, StringRef()));
+  if (result.second) {
+    result.first->second.offset = snapshot_->title_chars_.size();
+    result.first->second.length = value.size();
+    snapshot_->title_chars_.append(value);
+  }
+  return result.first->second;
+}
+
+// BookmarkSubtreeSnapshot ----------------------------------------------------
+
+BookmarkSubtreeSnapshot::BookmarkSubtreeSnapshot(const BookmarkNode* node) {
+  DCHECK(node);
+  {
+    Builder builder(this);
+    builder.AddNode(node);
+  }
+  // Release the slack left by growing the buffers, as the snapshot may be
+  // kept around for a long time.
+  std::vector<Node>(nodes_).swap(nodes_);
+  std::vector<std::pair<StringRef, StringRef> >(meta_info_).swap(meta_info_);
+  std::string(chars_).swap(chars_);
+  base::string16(title_chars_).swap(title_chars_);
+}
+
+BookmarkSubtreeSnapshot::~BookmarkSubtreeSnapshot() {
+}
+
+std::vector<BookmarkNodeData::Element>
+BookmarkSubtreeSnapshot::ToElements() const {
+  std::vector<BookmarkNodeData::Element> elements(1);
+  size_t end = ToElement(0, &elements[0]);
+  DCHECK_EQ(nodes_.size(), end);
+  return elements;
+}
+
+size_t BookmarkSubtreeSnapshot::EstimateMemoryUsage() const {
+  return sizeof(*this) +
+      nodes_.capacity() * sizeof(Node) +
+      meta_info_.capacity() * sizeof(meta_info_[0]) +
+      chars_.capacity() +
+      title_chars_.capacity() * sizeof(base::char16);
+}
+
+size_t BookmarkSubtreeSnapshot::ToElement(
+    size_t index,
+    BookmarkNodeData::Element* element) const {
+  const Node& node = nodes_[index];
+  element->is_url = node.is_url;
+  if (node.is_url)
+    element->url = GURL(GetString(node.url));
+  element->title = GetTitle(node.title);
+  element->date_added = base::Time::FromInternalValue(node.date_added);
+  element->date_folder_modified =
+      base::Time::FromInternalValue(node.date_folder_modified);
+  for (uint32 i = 0; i < node.meta_info_count; ++i) {
+    const std::pair<StringRef, StringRef>& entry =
+        meta_info_[node.meta_info_begin + i];
+    element->meta_info_map[GetString(entry.first)] = GetString(entry.second);
+  }
+
+  size_t next = index + 1;
+  element->children.resize(node.child_count);
+  for (int i = 0; i < node.child_count; ++i)
+    next = ToElement(next, &element->children[i]);
+  return next;
+}
+
+std::string BookmarkSubtreeSnapshot::GetString(const StringRef& ref) const {
+  return chars_.substr(ref.offset, ref.length);
+}
+
+base::string16 BookmarkSubtreeSnapshot::GetTitle(const StringRef& ref) const {
+  return title_chars_.substr(ref.offset, ref.length);
+}
@@ -0,0 +1,93 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_UNDO_BOOKMARK_SUBTREE_SNAPSHOT_H_
+#define CHROME_BROWSER_UNDO_BOOKMARK_SUBTREE_SNAPSHOT_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/strings/string16.h"
+#include "components/bookmarks/browser/bookmark_node_data.h"
+
+class BookmarkNode;
+
+// BookmarkSubtreeSnapshot ----------------------------------------------------
+
+// A compact, immutable copy of a bookmark node and all of its descendants,
+// kept by undo operations in order to restore removed bookmarks.
+//
+// Nodes are stored in a flat array in pre-order. Every distinct string (title,
+// URL, meta info key or value) is stored only once, in one of two character
+// buffers, and nodes refer to strings by offset. A snapshot of a large folder
+// therefore costs a fraction of the memory of the equivalent BookmarkNodeData.
+class BookmarkSubtreeSnapshot {
+ public:
+  explicit BookmarkSubtreeSnapshot(const BookmarkNode* node);
+  ~BookmarkSubtreeSnapshot();
+
+  // Returns the snapshot as a single BookmarkNodeData element tree, suitable
+  // for bookmark_utils::CloneBookmarkNode(). The ids of the elements are not
+  // set; use node_id() to get the ids the nodes had.
+  std::vector<BookmarkNodeData::Element> ToElements() const;
+
+  // Number of nodes in the snapshot. Node 0 is the root of the subtree and the
+  // children of a node follow it in pre-order.
+  size_t node_count() const { return nodes_.size(); }
+
+  // Returns the id node |index| had when the snapshot was taken.
+  int64 node_id(size_t index) const { return nodes_[index].id; }
+
+  // Returns the number of children of node |index|.
+  int node_child_count(size_t index) const {
+    return nodes_[index].child_count;
+  }
+
+  // Returns the approximate number of bytes used by the snapshot.
+  size_t EstimateMemoryUsage() const;
+
+ private:
+  class Builder;
+
+  // Location of a string in |chars_| or |title_chars_|.
+  struct StringRef {
+    uint32 offset;
+    uint32 length;
+  };
+
+  struct Node {
+    int64 id;
+    int64 date_added;
+    int64 date_folder_modified;
+    StringRef title;
+    StringRef url;
+    uint32 meta_info_begin;
+    uint32 meta_info_count;
+    int child_count;
+    bool is_url;
+  };
+
+  // Fills in |element| from node |index| and its descendants, and returns the
+  // index of the node following the subtree.
+  size_t ToElement(size_t index, BookmarkNodeData::Element* element) const;
+
+  std::string GetString(const StringRef& ref) const;
+  base::string16 GetTitle(const StringRef& ref) const;
+
+  std::vector<Node> nodes_;
+
+  // Meta info key/value pairs of all nodes, indexed by Node::meta_info_begin.
+  std::vector<std::pair<StringRef, StringRef> > meta_info_;
+
+  // Buffers holding the interned strings: UTF-8 URL specs and meta info, and
+  // UTF-16 titles.
+  std::string chars_;
+  base::string16 title_chars_;
+
+  DISALLOW_COPY_AND_ASSIGN(BookmarkSubtreeSnapshot);
+};
+
+#endif  // CHROME_BROWSER_UNDO_BOOKMARK_SUBTREE_SNAPSHOT_H_
@@ -0,0 +1,111 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/undo/bookmark_subtree_snapshot.h"
+
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
+#include "chrome/browser/bookmarks/bookmark_model_factory.h"
+#include "chrome/test/base/testing_profile.h"
+#include "components/bookmarks/browser/bookmark_model.h"
+#include "components/bookmarks/test/bookmark_test_helpers.h"
+#include "content/public/test/test_browser_thread_bundle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using base::ASCIIToUTF16;
+
+namespace {
+
+class BookmarkSubtreeSnapshotTest : public testing::Test {
+ public:
+  virtual void SetUp() OVERRIDE {
+    profile_.reset(new TestingProfile);
+    profile_->CreateBookmarkModel(true);
+    test::WaitForBookmarkModelToLoad(GetModel());
+  }
+
+  virtual void TearDown() OVERRIDE {
+    profile_.reset();
+  }
+
+  BookmarkModel* GetModel() {
+    return BookmarkModelFactory::GetForProfile(profile_.get());
+  }
+
+ private:
+  content::TestBrowserThreadBundle thread_bundle_;
+  scoped_ptr<TestingProfile> profile_;
+};
+
+void ExpectElementsEqual(const BookmarkNodeData::Element& expected,
+                         const BookmarkNodeData::Element& actual) {
+  EXPECT_EQ(expected.is_url, actual.is_url);
+  EXPECT_EQ(expected.url, actual.url);
+  EXPECT_EQ(expected.title, actual.title);
+  EXPECT_EQ(expected.date_added, actual.date_added);
+  EXPECT_EQ(expected.date_folder_modified, actual.date_folder_modified);
+  EXPECT_EQ(expected.meta_info_map, actual.meta_info_map);
+  ASSERT_EQ(expected.children.size(), actual.children.size());
+  for (size_t i = 0; i < expected.children.size(); ++i)
+    ExpectElementsEqual(expected.children[i], actual.children[i]);
+}
+
+TEST_F(BookmarkSubtreeSnapshotTest, RoundTrip) {
+  BookmarkModel* model = GetModel();
+  const BookmarkNode* folder =
+      model->AddFolder(model->other_node(), 0, ASCIIToUTF16("folder"));
+  model->SetNodeMetaInfo(folder, "key", "folder value");
+  const BookmarkNode* url1 = model->AddURL(
+      folder, 0, ASCIIToUTF16("a"), GURL("http://www.a.com/"));
+  model->SetNodeMetaInfo(url1, "key", "value");
+  const BookmarkNode* subfolder =
+      model->AddFolder(folder, 1, ASCIIToUTF16("subfolder"));
+  const BookmarkNode* url2 = model->AddURL(
+      subfolder, 0, ASCIIToUTF16("a"), GURL("http://www.a.com/"));
+  model->SetNodeMetaInfo(url2, "key", "value");
+  const BookmarkNode* url3 = model->AddURL(
+      folder, 2, ASCIIToUTF16("b"), GURL("http://www.b.com/"));
+
+  BookmarkSubtreeSnapshot snapshot(folder);
+
+  // Nodes are in pre-order.
+  ASSERT_EQ(5u, snapshot.node_count());
+  EXPECT_EQ(folder->id(), snapshot.node_id(0));
+  EXPECT_EQ(3, snapshot.node_child_count(0));
+  EXPECT_EQ(url1->id(), snapshot.node_id(1));
+  EXPECT_EQ(0, snapshot.node_child_count(1));
+  EXPECT_EQ(subfolder->id(), snapshot.node_id(2));
+  EXPECT_EQ(1, snapshot.node_child_count(2));
+  EXPECT_EQ(url2->id(), snapshot.node_id(3));
+  EXPECT_EQ(url3->id(), snapshot.node_id(4));
+
+  std::vector<BookmarkNodeData::Element> elements = snapshot.ToElements();
+  ASSERT_EQ(1u, elements.size());
+  BookmarkNodeData expected(folder);
+  ExpectElementsEqual(expected.elements[0], elements[0]);
+}
+
+// Strings shared by many bookmarks of a folder are only stored once.
+TEST_F(BookmarkSubtreeSnapshotTest, StringsAreInterned) {
+  BookmarkModel* model = GetModel();
+  const BookmarkNode* folder =
+      model->AddFolder(model->other_node(), 0, ASCIIToUTF16("folder"));
+  const size_t kBookmarkCount = 1000;
+  for (size_t i = 0; i < kBookmarkCount; ++i) {
+    const BookmarkNode* node = model->AddURL(
+        folder, i, ASCIIToUTF16("Some reasonably long bookmark title"),
+        GURL("http://www.example.com/a/reasonably/long/path"));
+    model->SetNodeMetaInfo(node, "last_visited",
+                           base::IntToString(static_cast<int>(i % 10)));
+  }
+
+  BookmarkSubtreeSnapshot snapshot(folder);
+  EXPECT_EQ(kBookmarkCount + 1, snapshot.node_count());
+
+  // Each node only costs its fixed-size record and one meta info entry; the
+  // shared title, URL and meta info strings are stored once.
+  EXPECT_LT(snapshot.EstimateMemoryUsage(), kBookmarkCount * 100);
+}
+
+}  // namespace
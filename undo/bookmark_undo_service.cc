@@ -7,14 +7,15 @@
 #include "chrome/browser/bookmarks/bookmark_model_factory.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/browser/undo/bookmark_renumber_observer.h"
+#include "chrome/browser/undo/bookmark_subtree_snapshot.h"
 #include "chrome/browser/undo/bookmark_undo_service_factory.h"
 #include "chrome/browser/undo/undo_operation.h"
 #include "components/bookmarks/browser/bookmark_model.h"
-#include "components/bookmarks/browser/bookmark_node_data.h"
 #include "components/bookmarks/browser/bookmark_utils.h"
 #include "components/bookmarks/browser/scoped_group_bookmark_actions.h"
 #include "grit/generated_resources.h"
 #include "ui/base/l10n/l10n_util.h"
+#include "url/gurl.h"
 
 namespace {
 
@@ -103,7 +104,8 @@ void BookmarkAddOperation::OnBookmarkRenumbered(int64 old_id, int64 new_id) {
 // BookmarkRemoveOperation ----------------------------------------------------
 
 // Handles the undo of the deletion of a bookmark node. For a bookmark folder,
-// the information for all descendant bookmark nodes is maintained.
+// the information for all descendant bookmark nodes is maintained in a
+// compact BookmarkSubtreeSnapshot.
 //
 // The BookmarkModel allows only single bookmark node to be removed.
 class BookmarkRemoveOperation : public BookmarkUndoOperation {
@@ -118,18 +120,20 @@ class BookmarkRemoveOperation : public BookmarkUndoOperation {
   virtual void Undo() OVERRIDE;
   virtual int GetUndoLabelId() const OVERRIDE;
   virtual int GetRedoLabelId() const OVERRIDE;
+  virtual size_t EstimateMemoryUsage() const OVERRIDE;
 
   // BookmarkRenumberObserver:
   virtual void OnBookmarkRenumbered(int64 old_id, int64 new_id) OVERRIDE;
 
  private:
-  void UpdateBookmarkIds(const BookmarkNodeData::Element& element,
-                         const BookmarkNode* parent,
-                         int index_added_at) const;
+  // Notifies the renumber observer of the new id of snapshot node |index|,
+  // which was restored as |node|, and of its descendants. Returns the index of
+  // the snapshot node following the subtree.
+  size_t UpdateBookmarkIds(size_t index, const BookmarkNode* node) const;
 
   int64 parent_id_;
   const int old_index_;
-  BookmarkNodeData removed_node_;
+  BookmarkSubtreeSnapshot removed_node_;
 
   DISALLOW_COPY_AND_ASSIGN(BookmarkRemoveOperation);
 };
@@ -145,14 +149,13 @@ BookmarkRemoveOperation::BookmarkRemoveOperation(Profile* profile,
 }
 
 void BookmarkRemoveOperation::Undo() {
-  DCHECK(removed_node_.is_valid());
   BookmarkModel* model = GetBookmarkModel();
   const BookmarkNode* parent = GetBookmarkNodeByID(model, parent_id_);
   DCHECK(parent);
 
-  bookmark_utils::CloneBookmarkNode(model, removed_node_.elements, parent,
+  bookmark_utils::CloneBookmarkNode(model, removed_node_.ToElements(), parent,
                                     old_index_, false);
-  UpdateBookmarkIds(removed_node_.elements[0], parent, old_index_);
+  UpdateBookmarkIds(0, parent->GetChild(old_index_));
 }
 
 int BookmarkRemoveOperation::GetUndoLabelId() const {
@@ -163,17 +166,21 @@ int BookmarkRemoveOperation::GetRedoLabelId() const {
   return IDS_BOOKMARK_BAR_REDO_ADD;
 }
 
-void BookmarkRemoveOperation::UpdateBookmarkIds(
-    const BookmarkNodeData::Element& element,
-    const BookmarkNode* parent,
-    int index_added_at) const {
-  const BookmarkNode* node = parent->GetChild(index_added_at);
-  if (element.id() != node->id())
-    GetUndoRenumberObserver()->OnBookmarkRenumbered(element.id(), node->id());
-  if (!element.is_url) {
-    for (int i = 0; i < static_cast<int>(element.children.size()); ++i)
-      UpdateBookmarkIds(element.children[i], node, 0);
+size_t BookmarkRemoveOperation::EstimateMemoryUsage() const {
+  return sizeof(*this) + removed_node_.EstimateMemoryUsage();
+}
+
+size_t BookmarkRemoveOperation::UpdateBookmarkIds(
+    size_t index,
+    const BookmarkNode* node) const {
+  if (removed_node_.node_id(index) != node->id()) {
+    GetUndoRenumberObserver()->OnBookmarkRenumbered(
+        removed_node_.node_id(index), node->id());
   }
+  size_t next = index + 1;
+  for (int i = 0; i < removed_node_.node_child_count(index); ++i)
+    next = UpdateBookmarkIds(next, node->GetChild(i));
+  return next;
 }
 
 void BookmarkRemoveOperation::OnBookmarkRenumbered(int64 old_id, int64 new_id) {
@@ -200,7 +207,10 @@ class BookmarkEditOperation : public BookmarkUndoOperation {
 
  private:
   int64 node_id_;
-  BookmarkNodeData original_bookmark_;
+  // Only the title and URL can be edited, so only those are kept rather than
+  // a copy of the node and, for folders, all of its descendants.
+  base::string16 original_title_;
+  GURL original_url_;
 
   DISALLOW_COPY_AND_ASSIGN(BookmarkEditOperation);
 };
@@ -209,18 +219,19 @@ BookmarkEditOperation::BookmarkEditOperation(Profile* profile,
                                              const BookmarkNode* node)
     : BookmarkUndoOperation(profile),
       node_id_(node->id()),
-      original_bookmark_(node) {
+      original_title_(node->GetTitle()) {
+  if (node->is_url())
+    original_url_ = node->url();
 }
 
 void BookmarkEditOperation::Undo() {
-  DCHECK(original_bookmark_.is_valid());
   BookmarkModel* model = GetBookmarkModel();
   const BookmarkNode* node = GetBookmarkNodeByID(model, node_id_);
   DCHECK(node);
 
-  model->SetTitle(node, original_bookmark_.elements[0].title);
-  if (original_bookmark_.elements[0].is_url)
-    model->SetURL(node, original_bookmark_.elements[0].url);
+  model->SetTitle(node, original_title_);
+  if (node->is_url())
+    model->SetURL(node, original_url_);
 }
 
 int BookmarkEditOperation::GetUndoLabelId() const {
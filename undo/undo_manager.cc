@@ -16,12 +16,17 @@ namespace {
 // Maximum number of changes that can be undone.
 const size_t kMaxUndoGroups = 100;
 
+// Maximum number of bytes held by the undo or the redo history. Once exceeded,
+// the oldest changes are dropped.
+const size_t kMaxUndoMemoryUsage = 4 * 1024 * 1024;
+
 }  // namespace
 
 // UndoGroup ------------------------------------------------------------------
 
 UndoGroup::UndoGroup()
-    : undo_label_id_(IDS_BOOKMARK_BAR_UNDO),
+    : memory_usage_(0),
+      undo_label_id_(IDS_BOOKMARK_BAR_UNDO),
       redo_label_id_(IDS_BOOKMARK_BAR_REDO) {
 }
 
@@ -33,6 +38,7 @@ void UndoGroup::AddOperation(scoped_ptr<UndoOperation> operation) {
     set_undo_label_id(operation->GetUndoLabelId());
     set_redo_label_id(operation->GetRedoLabelId());
   }
+  memory_usage_ += operation->EstimateMemoryUsage();
   operations_.push_back(operation.release());
 }
 
@@ -50,7 +56,8 @@ UndoManager::UndoManager()
       undo_in_progress_action_(NULL),
       undo_suspended_count_(0),
       performing_undo_(false),
-      performing_redo_(false) {
+      performing_redo_(false),
+      max_memory_usage_(kMaxUndoMemoryUsage) {
 }
 
 UndoManager::~UndoManager() {
@@ -215,10 +222,28 @@ void UndoManager::AddUndoGroup(UndoGroup* new_undo_group) {
   // Limit the number of undo levels so the undo stack does not grow unbounded.
   if (GetActiveUndoGroup()->size() > kMaxUndoGroups)
     GetActiveUndoGroup()->erase(GetActiveUndoGroup()->begin());
+  EnforceMemoryLimit(GetActiveUndoGroup());
 
   NotifyOnUndoManagerStateChange();
 }
 
+void UndoManager::EnforceMemoryLimit(ScopedVector<UndoGroup>* undo_group) {
+  size_t memory_usage = 0;
+  for (size_t i = 0; i < undo_group->size(); ++i)
+    memory_usage += (*undo_group)[i]->memory_usage();
+
+  size_t groups_to_remove = 0;
+  while (memory_usage > max_memory_usage_ &&
+         groups_to_remove + 1 < undo_group->size()) {
+    memory_usage -= (*undo_group)[groups_to_remove]->memory_usage();
+    ++groups_to_remove;
+  }
+  if (groups_to_remove) {
+    undo_group->erase(undo_group->begin(),
+                      undo_group->begin() + groups_to_remove);
+  }
+}
+
 ScopedVector<UndoGroup>* UndoManager::GetActiveUndoGroup() {
   return performing_undo_ ? &redo_actions_ : &undo_actions_;
 }
@@ -29,6 +29,9 @@ class UndoGroup {
   }
   void Undo();
 
+  // Approximate number of bytes held by the operations of this group.
+  size_t memory_usage() const { return memory_usage_; }
+
   // The resource string id describing the undo and redo action.
   int get_undo_label_id() const { return undo_label_id_; }
   void set_undo_label_id(int label_id) { undo_label_id_ = label_id; }
@@ -39,6 +42,8 @@ class UndoGroup {
  private:
   ScopedVector<UndoOperation> operations_;
 
+  size_t memory_usage_;
+
   // The resource string id describing the undo and redo action.
   int undo_label_id_;
   int redo_label_id_;
@@ -89,6 +94,10 @@ class UndoManager {
   void AddObserver(UndoManagerObserver* observer);
   void RemoveObserver(UndoManagerObserver* observer);
 
+  void set_max_memory_usage_for_testing(size_t max_memory_usage) {
+    max_memory_usage_ = max_memory_usage;
+  }
+
  private:
   void Undo(bool* performing_indicator,
             ScopedVector<UndoGroup>* active_undo_group);
@@ -100,6 +109,10 @@ class UndoManager {
   // Handle the addition of |new_undo_group| to the active undo group container.
   void AddUndoGroup(UndoGroup* new_undo_group);
 
+  // Removes the oldest groups of |undo_group| until it holds no more than
+  // |max_memory_usage_| bytes. The most recent group is always kept.
+  void EnforceMemoryLimit(ScopedVector<UndoGroup>* undo_group);
+
   // Returns the undo or redo UndoGroup container that should store the next
   // change taking into account if an undo or redo is being executed.
   ScopedVector<UndoGroup>* GetActiveUndoGroup();
@@ -128,6 +141,9 @@ class UndoManager {
   bool performing_undo_;
   bool performing_redo_;
 
+  // Maximum number of bytes held by each of the undo and redo containers.
+  size_t max_memory_usage_;
+
   DISALLOW_COPY_AND_ASSIGN(UndoManager);
 };
 
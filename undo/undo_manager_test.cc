@@ -29,28 +29,35 @@ class TestUndoService {
 
   int undo_operation_count_;
   int redo_operation_count_;
+
+  // Memory usage reported by the operations created by TriggerOperation().
+  size_t operation_memory_usage_;
 };
 
 // TestUndoOperation -----------------------------------------------------------
 
 class TestUndoOperation : public UndoOperation {
  public:
-  explicit TestUndoOperation(TestUndoService* undo_service);
+  TestUndoOperation(TestUndoService* undo_service, size_t memory_usage);
   virtual ~TestUndoOperation();
 
   // UndoOperation:
   virtual void Undo() OVERRIDE;
   virtual int GetUndoLabelId() const OVERRIDE;
   virtual int GetRedoLabelId() const OVERRIDE;
+  virtual size_t EstimateMemoryUsage() const OVERRIDE;
 
  private:
   TestUndoService* undo_service_;
+  size_t memory_usage_;
 
   DISALLOW_COPY_AND_ASSIGN(TestUndoOperation);
 };
 
-TestUndoOperation::TestUndoOperation(TestUndoService* undo_service)
-      : undo_service_(undo_service) {
+TestUndoOperation::TestUndoOperation(TestUndoService* undo_service,
+                                     size_t memory_usage)
+      : undo_service_(undo_service),
+        memory_usage_(memory_usage) {
 }
 
 TestUndoOperation::~TestUndoOperation() {
@@ -69,11 +76,16 @@ int TestUndoOperation::GetRedoLabelId() const {
   return 0;
 }
 
+size_t TestUndoOperation::EstimateMemoryUsage() const {
+  return memory_usage_;
+}
+
 // TestUndoService -------------------------------------------------------------
 
 TestUndoService::TestUndoService() : performing_redo_(false),
                                      undo_operation_count_(0),
-                                     redo_operation_count_(0) {
+                                     redo_operation_count_(0),
+                                     operation_memory_usage_(0) {
 }
 
 TestUndoService::~TestUndoService() {
@@ -85,7 +97,8 @@ void TestUndoService::Redo() {
 }
 
 void TestUndoService::TriggerOperation() {
-  scoped_ptr<TestUndoOperation> op(new TestUndoOperation(this));
+  scoped_ptr<TestUndoOperation> op(
+      new TestUndoOperation(this, operation_memory_usage_));
   undo_manager_.AddUndoOperation(op.PassAs<UndoOperation>());
 }
 
@@ -263,4 +276,31 @@ TEST(UndoServiceTest, ObserverCallbacks) {
   EXPECT_EQ(callback_count_after_redo, observer.state_change_count());
 }
 
+TEST(UndoServiceTest, MemoryLimit) {
+  TestUndoService undo_service;
+  undo_service.undo_manager_.set_max_memory_usage_for_testing(1000);
+  undo_service.operation_memory_usage_ = 300;
+
+  undo_service.TriggerOperation();
+  undo_service.TriggerOperation();
+  undo_service.TriggerOperation();
+  EXPECT_EQ(3U, undo_service.undo_manager_.undo_count());
+
+  // The oldest action is dropped once the limit is exceeded.
+  undo_service.TriggerOperation();
+  EXPECT_EQ(3U, undo_service.undo_manager_.undo_count());
+
+  // A single action larger than the limit is still kept on its own.
+  undo_service.undo_manager_.StartGroupingActions();
+  for (int i = 0; i < 5; ++i)
+    undo_service.TriggerOperation();
+  undo_service.undo_manager_.EndGroupingActions();
+  EXPECT_EQ(1U, undo_service.undo_manager_.undo_count());
+
+  undo_service.undo_manager_.Undo();
+  EXPECT_EQ(0U, undo_service.undo_manager_.undo_count());
+  EXPECT_EQ(1U, undo_service.undo_manager_.redo_count());
+  EXPECT_EQ(5, undo_service.undo_operation_count_);
+}
+
 } // namespace
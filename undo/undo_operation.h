@@ -5,6 +5,8 @@
 #ifndef CHROME_BROWSER_UNDO_UNDO_OPERATION_H_
 #define CHROME_BROWSER_UNDO_UNDO_OPERATION_H_
 
+#include <stddef.h>
+
 // Base class for all undo operations.
 class UndoOperation {
  public:
@@ -21,6 +23,11 @@ class UndoOperation {
   // UndoOperation of delete would be "Redo add".
   virtual int GetUndoLabelId() const = 0;
   virtual int GetRedoLabelId() const = 0;
+
+  // Returns the approximate number of bytes held by this operation. Used by
+  // UndoManager to bound the memory used by the undo history. Operations that
+  // only keep a few ids need not override this.
+  virtual size_t EstimateMemoryUsage() const { return 0; }
 };
 
 #endif  // CHROME_BROWSER_UNDO_UNDO_OPERATION_H_